@@ -16,14 +16,40 @@
 #include <windows.h>
 #include <ctime>
 #include <vector>
-#include <set>
 #include <cmath>
 #include <string>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <queue>
+#include <fstream>
+#include <sstream>
+#include <climits>
+#include <cstdint>
+#include <cassert>
+#if defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2) || defined (__SSE2__)
+#include <emmintrin.h>
+#define GRID_SSE2 // the heuristic of all 8 neighbours is found at the same time with SSE2 when the compiler targets it
+#endif
 
 const int screenWidth = 100, screenHeight = 25; // the amount of rows and columns in the 2D array. All 2D arrays(Pathfinding's Grid, Collision, Graphic) will have their number of elements based in these const values
 
 enum Direction { up, down, left, right };
 
+// what a collider is, the collision responses are picked by the kinds of the two colliders(Collider::collisionHandlers)
+enum ColliderKind { wallCollider, zombieCollider, playerCollider, attackCollider, colliderKindCount };
+
+// how the zombies find their way to the player, either an A* search for every zombie, or a single flow field shared by all of them
+enum PathStrategy { aStar, flowField, jumpPoint, incremental, hierarchical, bidirectional };
+
+// how much detail a zombie is simulated with, by how far it is from the player(ZombieManager::setDetailTiers)
+enum DetailTier { nearTier, midTier, farTier, detailTierCount };
+
 /**
 ** A User defined struct type to contain the X,Y value of a certain object.
 ** A struct was used because Vector2 is only going to contain pure data members(POD, plain old data) like integers and such
@@ -44,10 +70,19 @@ struct Vector2 {
 
 class Collider {
 	private:
+	typedef void (* CollisionHandler) (Collider *, Collider *); // the response of the first collider to colliding with the second one
+	/* the collider's handle in the collision matrix, it's slot in colliders + 1 in the low slotBits bits, and the generation of the slot above them,
+	so a handle left behind by a removed collider never matches the collider reusing it's slot*/
 	int id = 0;
-	static std::vector<Collider*> colliders;
-	static int currentId;
-	virtual void collided (Collider*) = 0;
+	ColliderKind kind;
+	static std::vector<Collider*> colliders; // by slot, NULL for a free slot
+	static std::vector<ColliderKind> kinds; // the kind of each collider, by slot like colliders, so a collision with no response never reads the other collider
+	static std::vector<int> generations; // of each slot, increased every time the collider in it is removed
+	static std::vector<int> freeSlots; // slots of removed colliders, reused before colliders grows
+	static const int slotBits = 20;
+	static const int generationMask = (1 << (31 - slotBits)) - 1;
+	static int getSlot (int);
+	static const CollisionHandler collisionHandlers [colliderKindCount] [colliderKindCount]; // by the kind of the collider that moved, then the kind of the one it collided with, NULL if nothing happens
 	protected:
 	Vector2 position, previousPosition, dimensions;
 	void clear (Vector2);
@@ -55,10 +90,16 @@ class Collider {
 	void updateCollisionMatrix ();
 	void checkCollisionMatrix ();
 	public:
-	Collider (Vector2, Vector2);
+	Collider (Vector2, Vector2, ColliderKind);
+	virtual ~Collider ();
 	void clear ();
 	Vector2 getPosition ();
+	int getId ();
+	ColliderKind getKind ();
 	static int collisionMatrix [screenWidth] [screenHeight];
+	static bool isAreaEmpty (Vector2, Vector2);
+	static Collider * getCollider (int);
+	static int getColliderSlots ();
 };
 
 class Graphics {
@@ -76,14 +117,17 @@ class Graphics {
 };
 
 class Wall : public Collider {
+	friend class Collider;
 	private:
 	Graphics graphics;
-	void collided (Collider *);
+	static void collidedWithWall (Collider *, Collider *);
 	void updateWalkableAreas ();
 	static bool initialized;
+	static int wallCellsBefore [screenWidth + 1] [screenHeight + 1]; // summed-area table of the wall cells, the number of them above and to the left of(not including) each x and y
 	public:
 	Wall (Vector2, Vector2);
 	static bool walkableAreas [screenWidth] [screenHeight];
+	static bool isAreaFree (Vector2, Vector2);
 };
 
 /**
@@ -101,12 +145,10 @@ class Node {
 					  **/
 	int gCost, hCost;
 	bool walkable; //if this Node is a wall, then ignore this Node when calculating the shortest path
-	int randomValue = rand (); //used to in the bool > operator for the std::set container
 	Node ();
 	Node (bool, Vector2);
 	static int getDistance (Node, Node);
-	static bool nodeInList (std::vector<Node> &, Node);
-	static void removeNodeFromVector (std::vector<Node> &, Node);
+	static int getDistance (Vector2, Vector2);
 	int getFCost (); //FCost is the sum of G and H cost
 
 					 //following operator overloadings are required to compare custom class types
@@ -116,33 +158,368 @@ class Node {
 	bool operator != (const Node &node) {
 		return !(*this == node);
 	}
-	bool operator < (const  Node &node) const {
-		return randomValue > node.randomValue;
-	}
 };
 
 // A grid is a class type that contains a grid of Node
 class Grid {
+	private:
+	static const int paddedHeight = screenHeight + 2;
+	static const int bitmapWords = ((screenWidth + 2) * paddedHeight + 63) / 64 + 1; // one word more than needed, so reading 3 bits that start in the last word never reads past the end
+	/* one bit for every cell, set if it's walkable, with a border of unwalkable cells all around the grid,
+	so the neighbours of any cell in the grid can be read without checking if they are inside it */
+	uint64_t walkableBits [bitmapWords];
+	/* how big a square, with it's top left corner on the cell, fits without covering a cell of a wall(0 if the cell is one), only counted up to footprintSize.
+	A Node is walkable when a whole zombie fits on it */
+	unsigned char clearance [screenWidth] [screenHeight];
+	int walkableCellSlot [screenWidth * screenHeight]; // the index of each cell in walkableCells, -1 if it's Node is not walkable
+	static int getBitIndex (int, int);
+	int getColumnBits (int, int);
+	int getClearance (int, int);
+	int calculateClearance (int, int);
 	public:
+	static const int footprintSize = 3; // zombies are 3 by 3, and their position is their top left cell
 	Node gridOfNode [screenWidth] [screenHeight]; //declaring the a 2d array of Node
+	static const int cellCount = screenWidth * screenHeight;
+	static const int directionX [8], directionY [8]; // the 8 directions to the neighbours, in the order of the bits from getOpenDirections
+	int creation = 0; // counts how many times the grid was created, so anything that remembers the grid knows when to start over
+	std::vector<int> changedCells; // cells whose walkable flag changed since the grid was created, in the order they changed
+	std::vector<int> walkableCells; // the cells of all the walkable Nodes in no order, so a random one(a place a zombie fits) can be picked in constant time
 	Grid ();
-	std::vector<Node> getNeighbours (Node);
+	bool isWalkable (int, int);
+	int getOpenDirections (int, int);
+	static void getNeighbourDistances (Vector2, Vector2, int []);
+	void setWalkable (Vector2, bool);
+	void updateClearance (Vector2, Vector2);
+	Vector2 getFootprintPosition (Vector2);
 	void create ();
+	static int getCellIndex (Vector2);
+	static Vector2 getCellPosition (int);
+};
+
+/**
+** The open list of the A* pathfinding, an indexed binary min-heap of grid positions ordered by fCost, then by hCost
+** Each position in the grid keeps a handle(it's index in the heap), so checking whether a Node is in the open list is a single array lookup,
+** and lowering the cost of a Node already in the open list only moves it up the heap instead of searching the whole list
+**/
+class OpenList {
+	private:
+	struct Entry {
+		int fCost, hCost;
+		Vector2 position;
+	};
+	std::vector<Entry> heap;
+	int handles [screenWidth] [screenHeight]; // index of each position in the heap, -1 if it's not in the open list
+	bool isLower (const Entry &, const Entry &);
+	void swapEntries (int, int);
+	int siftUp (int);
+	void siftDown (int);
+	public:
+	OpenList ();
+	bool empty ();
+	int size ();
+	bool contains (Vector2);
+	void push (Vector2, int, int);
+	Vector2 pop ();
+	void remove (Vector2);
+	Vector2 top ();
+	int getTopFCost ();
+	int getTopHCost ();
+	void clear ();
+};
+
+/**
+** The scratch state of a single search, the gCost and parent of every Node, and whether it has been closed, in flat arrays indexed by the Node's cell index
+** Instead of clearing the arrays before every search, every cell is stamped with the generation of the search that last visited it,
+** and a cell with an older stamp is treated as not visited yet, so starting a new search only increases the generation.
+** Each search writes only into it's own SearchState, and only reads the grid, so searches with different SearchStates can run at the same time
+**/
+class SearchState {
+	private:
+	unsigned int generation = 0;
+	unsigned int generations [Grid::cellCount];
+	int gCosts [Grid::cellCount];
+	int parents [Grid::cellCount];
+	bool closed [Grid::cellCount];
+	public:
+	OpenList openList;
+	Vector2 startPosition, targetPosition, lowerCorner, upperCorner; // of the search started with PathFinder::startSearch
+	bool searching = false; // true while that search has Nodes left to evaluate and hasn't reached the target
+	bool found = false;
+	SearchState ();
+	void reset ();
+	bool isVisited (int);
+	bool isClosed (int);
+	int getGCost (int);
+	int getParent (int);
+	void visit (int, int, int);
+	void close (int);
+};
+
+/**
+** An incremental planner(D* Lite), it keeps it's search between replans, so when the target moves by a cell or two, or a wall changes,
+** only the Nodes affected by the change are evaluated again, instead of searching again from scratch.
+** D* Lite is normally rooted at the target so the searcher can move, but here it's the target(the player) that moves every replan,
+** so the search is rooted at the zombie and grows towards the target. The search is kept until the zombie takes a step, then it starts again from the zombie's new position.
+** Every Node has a gCost and an rhsCost(the lowest gCost it could have, looking at it's neighbours), a Node is in the openList while they are different
+**/
+class IncrementalPlanner {
+	private:
+	unsigned int generation = 0;
+	unsigned int generations [Grid::cellCount]; // like the SearchState, a cell stamped with an older generation has both costs unreachable
+	int gCosts [Grid::cellCount];
+	int rhsCosts [Grid::cellCount];
+	OpenList openList;
+	Vector2 root, target;
+	int keyModifier = 0; // added to the keys of Nodes pushed after the target moved, instead of updating every key in the openList
+	int gridCreation = -1;
+	int seenChanges = 0;
+	int expansions = 0;
+	int getGCost (int);
+	int getRhsCost (int);
+	void setCosts (int, int, int);
+	static int getMoveCost (Vector2, Vector2);
+	void updateNode (Vector2);
+	void updateNeighbours (Vector2);
+	void computeShortestPath ();
+	void restart (Vector2, Vector2);
+	public:
+	static const int unreachable = 1 << 30;
+	static std::atomic<int> replans, restarts, totalExpansions;
+	IncrementalPlanner ();
+	void findPath (Vector2, Vector2, std::vector<int> &);
+	int getExpansions ();
 };
 
-//The brain of the A* path finding
+/**
+** The brain of the A* path finding
+** It can also search with Jump Point Search, which gives paths of the same cost, but on a grid where every move costs the same,
+** it skips over the many equally short paths in open areas by jumping in straight lines, and only adds the Nodes where the path has to turn(jump points) into the openList
+**/
 class PathFinder {
 	private:
+	std::unique_ptr<IncrementalPlanner> incrementalPlanner; // only created when the incremental strategy is first used, as it's much bigger than the rest of the PathFinder
+	static thread_local SearchState threadSearchState; // used when a search is not given a SearchState, every thread has it's own one so they never share it
+	static thread_local SearchState threadBackwardSearchState; // the second SearchState of a bidirectional search
+	std::vector<Vector2> waypoints; // the entrances of a hierarchical path, that have not been refined into the path yet
+	int nextWaypoint = 0;
+	Vector2 refinedPosition; // where the refined part of a hierarchical path ends
+	static bool jump (Vector2, int, int, Vector2, Vector2 &);
+	static int getJumpPointSuccessors (SearchState &, int, int, Vector2, Vector2 []);
+	static void retracePath (SearchState &, int, int, std::vector<int> &);
+	void retraceJumpPoints (SearchState &, int, int);
 	public:
-	static Grid grid; //since there is only 1 grid at a time, it would be declared as a static
-	std::vector<Node> path; // a path of nodes that contain the shortest path from the targetNode to endNode
+	static Grid grid; //since there is only 1 grid at a time, it would be declared as a static, searches only read from it
+	static bool verifyJumpPoint; // when true, every Jump Point Search is repeated with A*, and paths with a different cost are counted in jumpPointMismatches
+	static bool landmarkHeuristic; // when true, A* uses the LandmarkMap's lower bound whenever it's bigger than the octile distance
+	static std::atomic<int> jumpPointMismatches;
+	std::vector<int> path; // the cells(Grid::getCellIndex) of the shortest path from the currentNode to the targetNode, not counting the currentNode
 	void findPath (Vector2, Vector2);
-	void retracePath (Node, Node);
+	void findPath (Vector2, Vector2, SearchState &);
+	void findJumpPointPath (Vector2, Vector2);
+	void findJumpPointPath (Vector2, Vector2, SearchState &);
+	void findBidirectionalPath (Vector2, Vector2);
+	void findBidirectionalPath (Vector2, Vector2, SearchState &, SearchState &);
+	void findHierarchicalPath (Vector2, Vector2);
+	void findPath (Vector2, Vector2, PathStrategy);
+	bool refineNextSegment (std::vector<int> &);
+	void clearWaypoints ();
+	static bool findPathWithin (Vector2, Vector2, Vector2, Vector2, SearchState &, std::vector<int> &);
+	static void startSearch (Vector2, Vector2, Vector2, Vector2, SearchState &);
+	static int continueSearch (SearchState &, int, std::vector<int> &);
+	static void floodWithin (Vector2, Vector2, Vector2, SearchState &);
+	static void continueFloodWithin (Vector2, Vector2, SearchState &);
+	static int getPathCost (Vector2, std::vector<int> &);
+	static Vector2 getLinePoint (Vector2, Vector2, int);
+	static bool hasLineOfSight (Vector2, Vector2);
+	static void pullString (Vector2, std::vector<int> &);
+};
+
+/**
+** A hierarchical map for HPA* pathfinding. The grid is split into square clusters, and wherever two neighbouring clusters have walkable cells facing each other
+** along their border, an entrance is made with a Node on each side, as well as where the only way across is a diagonal step. The costs between the entrances inside each cluster are found once and cached,
+** so a long path is planned on the small graph of entrances, then refined cell by cell inside one cluster at a time, only when the zombie gets there.
+** When walls change, only the clusters they are in(and the neighbours sharing a border they are on) are built again
+**/
+class HierarchicalMap {
+	private:
+	struct Cluster {
+		std::vector<Vector2> entrances;
+		std::vector<int> costs; // the cost between every pair of entrances, entrances.size () by entrances.size (), unreachable if they are not connected inside the cluster
+		std::vector<int> fieldCosts; // the cost from every entrance to the target of the coarse flow field(updateField)
+		std::vector<int> cellCosts; // the cost from every cell of the cluster to the target of the coarse flow field, column by column, only found once a zombie in the cluster needs it(getFieldCost)
+		int cellCostsField = -1; // the fieldUpdates the cellCosts were found for
+	};
+	static std::vector<Cluster> clusters;
+	static int entranceOfCell [Grid::cellCount]; // index of the cell in it's cluster's entrances, -1 if it's not an entrance
+	static int gridCreation;
+	static int seenChanges;
+	static SearchState buildState;
+	static Vector2 fieldTarget;
+	static int fieldGridCreation;
+	static int fieldSeenChanges;
+	static int fieldCostLimit;
+	static int fieldUpdates; // the times the coarse flow field was calculated
+	static void addBorderEntrances (int, Vector2, Vector2, Vector2);
+	static void addEntrance (int, Vector2);
+	static int getCrossings (Vector2, Vector2 [], int []);
+	static void buildCluster (int);
+	static int getFieldCost (Vector2);
+	public:
+	static const int clusterSize = 10;
+	static const int maxSuccessors = clusterSize * 8 + 9; // a cluster has at most clusterSize entrances on each side, the start can reach all of them, and so can an entrance, plus 8 neighbours and the target
+	static const int clustersWide = (screenWidth + clusterSize - 1) / clusterSize;
+	static const int clustersHigh = (screenHeight + clusterSize - 1) / clusterSize;
+	static const int unreachable = 1 << 30;
+	static int rebuiltClusters;
+	static void update ();
+	static int getCluster (Vector2);
+	static void getClusterBounds (int, Vector2 &, Vector2 &);
+	static bool findAbstractPath (Vector2, Vector2, SearchState &, std::vector<Vector2> &);
+	static void updateField (Vector2, int);
+	static bool getFieldWaypoint (Vector2, Vector2 &);
+};
+
+/**
+** Landmarks for the ALT heuristic(A*, Landmarks and the Triangle inequality). A few cells far apart from each other are picked as landmarks,
+** and the cost from each of them to every cell is found once when the map is loaded. By the triangle inequality, the cost from a cell to the target
+** is at least the difference of their costs from any landmark, and the biggest of those differences is a much closer guess than the octile distance when walls are in the way.
+** The tables are saved to a file named after a hash of the walkable cells, so the same map is only calculated once
+**/
+class LandmarkMap {
+	private:
+	static std::vector<int> landmarks;
+	static std::vector<int> costs; // the cost from every landmark to every cell, the landmarkCount costs of a cell are next to each other
+	static unsigned int mapHash;
+	static int gridCreation;
+	static int seenChanges;
+	static SearchState buildState;
+	static unsigned int hashMap ();
+	static std::string getFileName (unsigned int);
+	static bool load (unsigned int);
+	static void save ();
+	static void calculate ();
+	public:
+	static const int landmarkCount = 8;
+	static const int unreachable = 1 << 30;
+	static bool ready;
+	static double calculateMilliseconds; // how long the last calculate took, 0 if the tables were loaded from the file
+	static void update ();
+	static int getLowerBound (int, int);
+	static int getMemoryUsage ();
+};
+
+/**
+** A flow field is a map of the movement cost from every position to a single target(the player), found with Dijkstra's algorithm
+** Since every zombie is chasing the same target, the field only has to be calculated once each time the target moves,
+** then each zombie finds it's next step by picking the neighbour closest to the target, instead of running it's own A* search
+**/
+class FlowField {
+	private:
+	static int costs [screenWidth] [screenHeight];
+	static OpenList openList;
+	static Vector2 target;
+	static bool calculated;
+	public:
+	static const int unreachable = 1 << 30;
+	static void calculate (Vector2);
+	static void invalidate ();
+	static bool getNextStep (Vector2, Vector2 &);
+};
+
+/**
+** A path request is a single search to be done by the PathWorkerPool, the path found is left in the pathFinder's path
+**/
+struct PathRequest {
+	PathFinder * pathFinder;
+	Vector2 startPosition, targetPosition;
+	PathStrategy pathStrategy;
+};
+
+/**
+** A fixed number of worker threads that share out a batch of path requests between them, so the searches for every zombie run on all the cores at the same time
+** Requests are added with add, the batch is started with start, and wait blocks until every search in the batch is done.
+** Each worker searches with it's own SearchState, and each request writes only into it's own PathFinder, so the workers never write to the same memory
+**/
+class PathWorkerPool {
+	private:
+	std::vector<std::thread> workers;
+	std::vector<PathRequest> pendingRequests; // requests added since the last batch started, only touched by the thread that owns the pool
+	std::vector<PathRequest> requests; // the batch being worked on
+	std::atomic<int> nextRequest;
+	std::mutex mutex; // guards every member below
+	std::condition_variable batchStarted, batchFinished;
+	int batch = 0;
+	int requestCount = 0;
+	int unfinishedRequests = 0;
+	int activeWorkers = 0;
+	bool stopping = false;
+	void work ();
+	public:
+	PathWorkerPool (int);
+	~PathWorkerPool ();
+	int getThreadCount ();
+	void add (PathRequest);
+	void start ();
+	void wait ();
+};
+
+/**
+** A pool of objects of one type, for the zombies and attacks that are created and destroyed all game long.
+** The objects are made in blocks of blockSize slots that are never given back, and a slot that is released goes on a free list,
+** so once the pool has as many slots as there are objects alive at the same time, acquire and release don't allocate any more
+**/
+template <class T>
+class ObjectPool {
+	private:
+	union Slot {
+		Slot * nextFree;
+		typename std::aligned_storage<sizeof (T), alignof (T)>::type object;
+	};
+	static const int blockSize = 64;
+	std::vector<std::unique_ptr<Slot []>> blocks;
+	Slot * firstFree = NULL;
+	int used = 0;
+	public:
+	template <class... Arguments> T * acquire (Arguments &&...);
+	void release (T *);
+	int getUsed ();
+	int getCapacity ();
+};
+
+/**
+** Keeps the paths of every zombie in one shared buffer of cells, instead of a vector for each zombie
+** A path is stored in a block with room for a power of two cells, and is refered to by a handle(the index of it's block).
+** Released blocks are kept in a free list for their size and reused by the next path that fits, so once the buffer is big enough repaths stop allocating
+**/
+class PathArena {
+	private:
+	struct Block {
+		int offset; // of it's first cell in cells
+		int sizeClass; // the block has room for minimumCapacity << sizeClass cells
+		int length;
+	};
+	static const int minimumCapacity = 8;
+	static const int sizeClasses = 32;
+	std::vector<int> cells;
+	std::vector<Block> blocks;
+	std::vector<int> freeBlocks [sizeClasses];
+	static int getSizeClass (int);
+	int allocate (int);
+	public:
+	static const int none = -1; // the handle of an empty path
+	int assign (int, std::vector<int> &);
+	int append (int, std::vector<int> &);
+	void release (int);
+	int getLength (int);
+	int getCell (int, int);
+	int getMemoryUsage ();
 };
 
 class Attack : public Collider {
+	friend class Collider;
 	private:
-	void collided (Collider *);
+	static void collidedWithZombie (Collider *, Collider *);
+	static void collidedWithWall (Collider *, Collider *);
 	bool blocked = false;
 	public:
 	Attack (Vector2, Vector2);
@@ -150,6 +527,7 @@ class Attack : public Collider {
 };
 
 class Player : public Collider {
+	friend class Collider;
 	private:
 	char defaultPose [9] = { ' ', 'O', ' ', '/', '|', 92, '/', '`', 92 };
 	char attackUpPose [12] = { ' ', ' ', ' ', 92, 'O', '/', ' ', '|', ' ', '/', '`', 92 };
@@ -162,8 +540,10 @@ class Player : public Collider {
 	char previousMovementInput;
 	void endAttack ();
 	Attack * attack = NULL;
+	ObjectPool<Attack> attackPool;
 	Graphics graphics;
-	void collided (Collider *);
+	static void collidedWithZombie (Collider *, Collider *);
+	static void collidedWithWall (Collider *, Collider *);
 	int health = 10;
 	void die ();
 	bool dead = false;
@@ -178,36 +558,165 @@ class Player : public Collider {
 };
 
 class Zombie : public Collider {
+	friend class Collider;
 	private:
 	char defaultPose [9] = { ' ', 'C', ' ', '/', 'l', '`', '/', '`', '?' };
-	int moveTimer;
-	int moveInterval = 10;
 	PathFinder pathFinder;
-	int pathIndex = 0;
-	std::vector <Node> path;
+	PathStrategy pathStrategy = aStar;
+	int pathIndex = 0; // the waypoint the zombie is walking to
+	int path = PathArena::none; // handle of the zombie's path in the pathArena, the waypoints left by PathFinder::pullString
+	Vector2 segmentStart; // the waypoint(or position) the zombie is walking from, it walks the line from there to the next waypoint
+	int segmentStep = 0;
+	Vector2 target; // the position the zombie was last told to go to, it's path can end a little away from it when the repath was skipped
+	int pathGridCreation = -1; // the grid's creation and number of changedCells when the path was last known to be clear, so it's only checked again after walls change
+	int pathSeenChanges = 0;
+	bool pathOutdated = false;
 	Graphics graphics;
 	bool dead = false;
-	void collided (Collider *);
-	void move ();
+	static void collidedWithAttack (Collider *, Collider *);
+	static void collidedWithPlayer (Collider *, Collider *);
+	static void collidedWithWall (Collider *, Collider *);
 	bool spawnSuccessful = true;
+	bool pathRequested = false;
+	bool pathScheduled = false;
+	int index = -1; // in ZombieManager::zombies
+	void setPath (std::vector<int> &);
+	bool isPathBlocked ();
+	bool getSteeringStep (Vector2, Vector2, Vector2 &);
+	void moveTo (Vector2);
 	public:
-	Zombie (Vector2, Vector2);
-	void update ();
-	void calculatePath (Vector2);
+	static int searchesSkipped, searchesDone; // paths taken straight to the target because it was in line of sight, and paths that had to be searched for
+	static long long pathCells, pathWaypoints; // the cells in the paths found, and the waypoints stored for them after pulling the string
+	static bool lazyRepaths; // when true, a zombie only searches again when the target drifted too far from the end of it's path, or the path is blocked
+	static bool verifyRepaths; // when true, every skipped repath checks that the target can still be reached from the end of the path kept, and repaths if not
+	static int repathDistanceRatio; // the target may drift up to 1 / repathDistanceRatio of the distance between the zombie and the target before it repaths
+	static int repathsAvoided, pathsExtended, repathsForDrift, repathsForBlocks, repathVerifyFailures;
+	static int deaths; // counts every zombie that died, so the ZombieManager only looks for dead zombies after some did
+	Zombie (Vector2);
+	~Zombie ();
+	void move ();
+	bool followCoarseField (int);
+	void steer (Vector2, int);
+	void calculatePath (Vector2, PathStrategy);
+	void requestPath (Vector2, PathStrategy, PathWorkerPool &);
+	void receivePath ();
+	void receivePath (std::vector<int> &);
+	void releasePath ();
+	bool followLineOfSight (Vector2);
+	bool needsPath (Vector2, PathStrategy);
+	static PathArena pathArena;
+	static Zombie * getZombie (int);
+	bool getDead ();
+	bool getPathOutdated ();
+	bool getPathScheduled ();
+	void setPathScheduled (bool);
+	int getIndex ();
+	void setIndex (int);
 	void die ();
 };
 
+/**
+** Spreads the A* searches for the zombies over many updates, so a burst of requests after the player moves can't make one update take too long.
+** Every update it evaluates at most a given number of Nodes(the expansion budget), a search that runs out of budget is carried on where it stopped in the next update.
+** Requests are searched closest zombie first, and each zombie keeps following it's old path until it's new one is found.
+** A zombie that leaves the near tier(ZombieManager::setDetailTiers) is removed, so no budget is spent on a path it wouldn't follow
+**/
+class PathScheduler {
+	private:
+	struct ScheduledPath {
+		int zombie; // the zombie's collider id(Zombie::getZombie), so a zombie given back to the pool while it waits is just skipped
+		int distance; // from the zombie to the target when it was scheduled
+		int scheduledTick;
+		bool operator < (const ScheduledPath & other) const { return distance > other.distance; } // so the priority_queue has the closest zombie on top
+	};
+	std::priority_queue<ScheduledPath> queue;
+	ScheduledPath current; // the request being searched, it's zombie is 0 if there is none
+	bool currentOutdated = false; // the target moved after the current search started, so it's zombie is scheduled again once it's done
+	SearchState state;
+	std::vector<int> path;
+	Vector2 target;
+	int tick = 0;
+	int gridCreation = -1;
+	int seenChanges = 0;
+	int completedPaths = 0;
+	int totalLatency = 0;
+	int maxLatency = 0;
+	void startNext ();
+	void finishCurrent ();
+	public:
+	PathScheduler ();
+	void setTarget (Vector2);
+	void add (Zombie *);
+	void remove (Zombie *);
+	void update (int);
+	int getQueueDepth ();
+	float getAverageLatency ();
+	int getMaxLatency ();
+};
+
 class ZombieManager {
 	private:
 	int zombieSpawnTimer = 0;
 	int zombieSpawnInterval = 45;
 	int waves = 0;
-	void spawnZombie (Vector2);
+	int spawnedZombies = 0; // counting the ones already dead and removed
+	int spawnBatchSize = 1; // how many zombies are spawned every zombieSpawnInterval
+	int minimumSpawnDistance = 0; // zombies don't spawn closer to the player than this(Node::getDistance)
+	static const int spawnAttempts = 16; // random places tried for a zombie before it's spawn is given up on until the next interval
+	bool spawnZombie (Vector2);
+	int spawnZombies (Vector2, int);
 	void updateZombies ();
+	void removeDeadZombies ();
+	ObjectPool<Zombie> zombiePool;
 	std::vector<Zombie *> zombies;
+	// the state of the zombies the ZombieManager reads and writes, by the zombie's index in zombies, kept in arrays of their own so it's contiguous
+	std::vector<int> moveIntervals; // a zombie moves once every moveInterval + 1 updates, picked when it's spawned
+	std::vector<Vector2> zombiePositions;
+	struct ScheduledMove {
+		int zombie; // the zombie's collider id(Zombie::getZombie), so a zombie that died and was removed is just skipped
+		int laps; // the times the moveWheel has to go round before the move is due, for intervals as long as the wheel or longer
+	};
+	/* a timing wheel of the zombies' next moves, slot tick % moveWheelSize has the moves due in that update, so an update only visits the zombies that move.
+	Every zombie is in it once, and puts itself back interval + 1 updates later after moving*/
+	static const int moveWheelSize = 64;
+	std::vector<ScheduledMove> moveWheel [moveWheelSize];
+	std::vector<ScheduledMove> dueMoves;
+	int tick = 0;
+	int minimumMoveInterval = 10; // the moveIntervals of the zombies spawned are picked at random from minimumMoveInterval to maximumMoveInterval
+	int maximumMoveInterval = 10;
+	int seenDeaths = 0;
+	/* the zombies near the player move with their pathStrategy one step at a time, the ones further than midTierDistance follow the shared coarse flow field(HierarchicalMap::updateField),
+	and the ones further than farTierDistance just steer at the player. Those take tierSteps steps at once, that many times less often, and only collide where they land*/
+	int midTierDistance = 1500;
+	int farTierDistance = 4000;
+	static const int tierSteps [detailTierCount];
+	std::vector<unsigned char> zombieTiers;
+	Vector2 playerFootprint; // where the zombies are going in this update, the tiers are measured from it
+	Vector2 midTierTarget; // where the coarse flow field the mid tier follows leads
+	DetailTier getDetailTier (int);
+	void updateMidTierField ();
+	void addZombie (Zombie *, DetailTier, int);
+	void scheduleMove (Zombie *, int);
+	PathStrategy pathStrategy = flowField;
+	PathWorkerPool pathWorkerPool;
+	bool pathsRequested = false;
+	PathScheduler pathScheduler;
+	bool timeSlicedPaths = false;
+	int expansionBudget = 2000;
+	Vector2 target; // where the zombies were last sent
+	void receivePaths ();
 	public:
 	ZombieManager ();
+	~ZombieManager ();
 	int getWaves ();
+	void setPathStrategy (PathStrategy);
+	void setTimeSlicedPaths (bool, int);
+	void setSpawning (int, int);
+	void setDetailTiers (int, int);
+	void setMoveIntervals (int, int);
+	bool getTimeSlicedPaths ();
+	int getQueuedPaths ();
+	float getPathLatency ();
 	void calculateZombiesPaths (Vector2);
 	int getZombieAmount ();
 	void update (Vector2);
@@ -254,25 +763,6 @@ Node::Node () {}
 
 Node::Node (bool walkable, Vector2 position) : walkable (walkable), position (position) {}
 
-/**
-** Remove node in a Vector of type Node, using an for-loop
-**/
-void Node::removeNodeFromVector (std::vector<Node> & vector, Node node) {
-	for (int i = 0; i < vector.size (); i++)
-		if (vector [i] == node)
-			vector.erase (vector.begin () + i);
-}
-
-/**
-** A bool function that returns true if Node is in a vector, and false otherwise
-**/
-bool Node::nodeInList (std::vector<Node> & list, Node node) {
-	for (Node nodeToCheck : list)
-		if (nodeToCheck == node)
-			return true;
-	return false;
-}
-
 /**
 ** A function with a formula to get the movementCost between one Node to the other
 ** 14 will be the 1 diagonal move
@@ -281,8 +771,12 @@ bool Node::nodeInList (std::vector<Node> & list, Node node) {
 ** for eficiency reason, multiplying these values by 10 to get a whole number will reduce workload for the computer
 **/
 int Node::getDistance (Node nodeA, Node nodeB) {
-	int distanceX = abs (nodeA.position.x - nodeB.position.x);
-	int distanceY = abs (nodeA.position.y - nodeB.position.y);
+	return getDistance (nodeA.position, nodeB.position);
+}
+
+int Node::getDistance (Vector2 positionA, Vector2 positionB) {
+	int distanceX = abs (positionA.x - positionB.x);
+	int distanceY = abs (positionA.y - positionB.y);
 	if (distanceX > distanceY)
 		return 14 * distanceY + 10 * (distanceX - distanceY);
 	return 14 * distanceX + 10 * (distanceY - distanceX);
@@ -292,133 +786,1706 @@ int Node::getFCost () {
 	return hCost + gCost;
 }
 
-Grid::Grid () {}
+const int Grid::directionX [8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
 
-//initializing the gridOfNode with Nodes
+const int Grid::directionY [8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+
+const int Grid::footprintSize; // defined here as well, because std::min takes it by reference
+
+Grid::Grid () {
+	for (int i = 0; i < bitmapWords; i++)
+		walkableBits [i] = 0;
+	for (int i = 0; i < cellCount; i++)
+		walkableCellSlot [i] = -1;
+}
+
+//initializing the clearance from the walls, then the gridOfNode with Nodes, and the walkable bitmap from them
 void Grid::create () {
+	for (int i = 0; i < bitmapWords; i++)
+		walkableBits [i] = 0;
+	for (int x = screenWidth - 1; x >= 0; x--)
+		for (int y = screenHeight - 1; y >= 0; y--)
+			clearance [x] [y] = calculateClearance (x, y);
+	walkableCells.clear ();
 	for (int x = 0; x < screenWidth; x++) {
 		for (int y = 0; y < screenHeight; y++) {
-			bool walkable = Wall::walkableAreas [x] [y];
+			bool walkable = clearance [x] [y] >= footprintSize;
 			gridOfNode [x] [y] = Node (walkable, Vector2 (x, y));
+			walkableCellSlot [getCellIndex (Vector2 (x, y))] = -1;
+			if (walkable) {
+				walkableBits [getBitIndex (x, y) >> 6] |= (uint64_t) 1 << (getBitIndex (x, y) & 63);
+				walkableCellSlot [getCellIndex (Vector2 (x, y))] = walkableCells.size ();
+				walkableCells.push_back (getCellIndex (Vector2 (x, y)));
+			}
 		}
 	}
+	creation++;
+	changedCells.clear ();
+}
+
+// changes whether a Node is walkable, and remembers the change for the incremental planners
+void Grid::setWalkable (Vector2 position, bool walkable) {
+	if (gridOfNode [position.x] [position.y].walkable == walkable)
+		return;
+	gridOfNode [position.x] [position.y].walkable = walkable;
+	int bitIndex = getBitIndex (position.x, position.y);
+	walkableBits [bitIndex >> 6] ^= (uint64_t) 1 << (bitIndex & 63);
+	int cell = getCellIndex (position);
+	changedCells.push_back (cell);
+	if (walkable) {
+		walkableCellSlot [cell] = walkableCells.size ();
+		walkableCells.push_back (cell);
+	} else { // the last cell is moved into it's slot, so the cell is taken out without shifting the rest
+		walkableCellSlot [walkableCells.back ()] = walkableCellSlot [cell];
+		walkableCells [walkableCellSlot [cell]] = walkableCells.back ();
+		walkableCells.pop_back ();
+		walkableCellSlot [cell] = -1;
+	}
+}
+
+// the clearance of a cell, 0 outside the grid
+int Grid::getClearance (int x, int y) {
+	return x < screenWidth && y < screenHeight ? clearance [x] [y] : 0;
+}
+
+// a square fits on a cell if it's not a wall, and the square one smaller fits on the cells to the right, below, and diagonally between them
+int Grid::calculateClearance (int x, int y) {
+	if (!Wall::walkableAreas [x] [y])
+		return 0;
+	return std::min (footprintSize, 1 + std::min (getClearance (x + 1, y), std::min (getClearance (x, y + 1), getClearance (x + 1, y + 1))));
 }
 
 /**
-** A function that returns a vector of Nodes
-** Used to get the neighbour nodes of a given node(passed in as argument)
+** Updates the clearance after the walls from lowerCorner up to(not including) upperCorner changed, and which Nodes are walkable because of it
+** Only the cells up to footprintSize - 1 above and to the left of the change can have a different clearance, as it's not counted any higher than that
 **/
-std::vector<Node> Grid::getNeighbours (Node nodeToFind) {
-	std::vector<Node> neighbours;
-	for (int x = -1; x <= 1; x++) {
-		for (int y = -1; y <= 1; y++) {
-			if (x == 0 && y == 0)
-				continue;
-			int checkForX = nodeToFind.position.x + x;
-			int checkForY = nodeToFind.position.y + y;
-			if (checkForX > 0 && checkForX < screenWidth && checkForY > 0 && checkForY < screenHeight) // check if node is within the Grid(array of Nodes)
-				neighbours.push_back (gridOfNode [checkForX] [checkForY]); // if so, add it into the neighbours vector
+void Grid::updateClearance (Vector2 lowerCorner, Vector2 upperCorner) {
+	for (int x = upperCorner.x - 1; x >= std::max (0, lowerCorner.x - footprintSize + 1); x--) {
+		for (int y = upperCorner.y - 1; y >= std::max (0, lowerCorner.y - footprintSize + 1); y--) {
+			clearance [x] [y] = calculateClearance (x, y);
+			setWalkable (Vector2 (x, y), clearance [x] [y] >= footprintSize);
 		}
 	}
-	return neighbours; // return neighbours if any
 }
 
-Grid PathFinder::grid; //initialzing the static grid
+/* the closest walkable Node from which a zombie covers position, so a target beside a wall(where a whole zombie can't have it's top left corner) can still be reached.
+position itself if there is none*/
+Vector2 Grid::getFootprintPosition (Vector2 position) {
+	for (int offset = 0; offset < footprintSize; offset++)
+		for (int x = position.x - offset; x <= position.x; x++)
+			for (int y = position.y - offset; y <= position.y; y++)
+				if ((x == position.x - offset || y == position.y - offset) && x >= 0 && y >= 0 && isWalkable (x, y))
+					return Vector2 (x, y);
+	return position;
+}
+
+// the index of a position in the walkable bitmap, the positions in the border are -1 and screenWidth(or screenHeight)
+int Grid::getBitIndex (int x, int y) {
+	return (x + 1) * paddedHeight + y + 1;
+}
+
+// the bits of (x, y - 1), (x, y) and (x, y + 1) in the walkable bitmap, as they are next to each other
+int Grid::getColumnBits (int x, int y) {
+	int bitIndex = getBitIndex (x, y - 1);
+	uint64_t bits = walkableBits [bitIndex >> 6] >> (bitIndex & 63);
+	if ((bitIndex & 63) > 61) // the 3 bits carry on into the next word
+		bits |= walkableBits [(bitIndex >> 6) + 1] << (64 - (bitIndex & 63));
+	return bits & 7;
+}
+
+/**
+** A bit for each of the 8 neighbours of a position in the grid that is walkable, in the order of directionX and directionY
+** It's read from the three columns of the bitmap the neighbours are in, so it's 3 reads instead of 8
+**/
+int Grid::getOpenDirections (int x, int y) {
+	int middle = getColumnBits (x, y);
+	return getColumnBits (x - 1, y) | (middle & 1) << 3 | (middle >> 2) << 4 | getColumnBits (x + 1, y) << 5;
+}
+
+/**
+** The octile distance(Node::getDistance) from each of the 8 neighbours of position to target, in the order of directionX and directionY
+** The distance is 14 for every diagonal step and 10 for every straight one, which is the same as 10 * the longer side + 4 * the shorter side
+**/
+void Grid::getNeighbourDistances (Vector2 position, Vector2 target, int distances []) {
+#ifdef GRID_SSE2
+	// 16 bit lanes are enough, as the longest distance in a grid is less than 14 times it's longest side
+	__m128i zero = _mm_setzero_si128 ();
+	__m128i xs = _mm_add_epi16 (_mm_set1_epi16 (position.x - target.x), _mm_setr_epi16 (-1, -1, -1, 0, 0, 1, 1, 1));
+	__m128i ys = _mm_add_epi16 (_mm_set1_epi16 (position.y - target.y), _mm_setr_epi16 (-1, 0, 1, -1, 1, -1, 0, 1));
+	xs = _mm_max_epi16 (xs, _mm_sub_epi16 (zero, xs));
+	ys = _mm_max_epi16 (ys, _mm_sub_epi16 (zero, ys));
+	__m128i longer = _mm_max_epi16 (xs, ys), shorter = _mm_min_epi16 (xs, ys);
+	__m128i result = _mm_add_epi16 (_mm_mullo_epi16 (longer, _mm_set1_epi16 (10)), _mm_slli_epi16 (shorter, 2));
+	_mm_storeu_si128 ((__m128i *) distances, _mm_unpacklo_epi16 (result, zero));
+	_mm_storeu_si128 ((__m128i *) (distances + 4), _mm_unpackhi_epi16 (result, zero));
+#else
+	for (int direction = 0; direction < 8; direction++)
+		distances [direction] = Node::getDistance (Vector2 (position.x + directionX [direction], position.y + directionY [direction]), target);
+#endif
+}
+
+// the index of a position in the flat arrays used by the pathfinding, the same order as the 2d arrays(all the y of the first x come first)
+int Grid::getCellIndex (Vector2 position) {
+	return position.x * screenHeight + position.y;
+}
+
+Vector2 Grid::getCellPosition (int cellIndex) {
+	return Vector2 (cellIndex / screenHeight, cellIndex % screenHeight);
+}
+
+// initializing every handle to -1, as the open list starts empty
+OpenList::OpenList () {
+	for (int x = 0; x < screenWidth; x++)
+		for (int y = 0; y < screenHeight; y++)
+			handles [x] [y] = -1;
+}
+
+// the lower entry is the one with the lower fCost, if they are the same, the one with the lower hCost(closer to the targetNode)
+bool OpenList::isLower (const Entry & entryA, const Entry & entryB) {
+	if (entryA.fCost != entryB.fCost)
+		return entryA.fCost < entryB.fCost;
+	return entryA.hCost < entryB.hCost;
+}
+
+// swaps two entries in the heap, and keeps their handles pointing at their new indexes
+void OpenList::swapEntries (int indexA, int indexB) {
+	std::swap (heap [indexA], heap [indexB]);
+	handles [heap [indexA].position.x] [heap [indexA].position.y] = indexA;
+	handles [heap [indexB].position.x] [heap [indexB].position.y] = indexB;
+}
 
-					   // function to retrace path, so other classes can use the information
-void PathFinder::retracePath (Node startNode, Node endNode) {
-	Node currentNode = endNode;
-	while (currentNode != startNode) {
-		path.push_back (currentNode);
-		currentNode = grid.gridOfNode [currentNode.parentPosition.x] [currentNode.parentPosition.y];
+// moves an entry up the heap until it's parent is lower than it, and returns where it ended up
+int OpenList::siftUp (int index) {
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+		if (!isLower (heap [index], heap [parent]))
+			break;
+		swapEntries (index, parent);
+		index = parent;
 	}
-	std::reverse (path.begin (), path.end ()); //reverse the path 
+	return index;
 }
 
-// Most important function, to find the shortest path from an currentPos to TargetPos, if there's one, call retracePath function to start retracing path
-void PathFinder::findPath (Vector2 currentPosition, Vector2 targetPosition) {
-	Node startNode = grid.gridOfNode [currentPosition.x] [currentPosition.y]; //find the node on the originPos
-	Node endNode = grid.gridOfNode [targetPosition.x] [targetPosition.y]; // find the node on targetPos
-	std::vector<Node> openList; // openList is a vector that contains Node that should be evaluated(to check if the path through it will the be shortest)
-								// closedList is a set because the ordering of the closed list does not matter match, as we only want to check whether a Node is contained in this set. 
-								// The set.count function has a low complexity(log(n)), therefore it's preferred
-	std::set<Node> closedList;
-	openList.push_back (startNode); //first add currentnode to openList, as it's the first node to be evaluated
-									//keep looping until there is no more Node in openList, which means all nodes has been evaluated
-	while (openList.size () > 0) {
-		Node currentNode = openList [0];
-		for (int i = 1; i < openList.size (); i++)
-			if (currentNode.getFCost () > openList [i].getFCost () || currentNode.getFCost () == openList [i].getFCost ()) // make the Node in openList with the lowest fCost to be the currentNode, if they are the same, determine them by comparing their hCost(lesser hCost means closer to targetNode)
-				if (openList [i].hCost < currentNode.hCost)
-					currentNode = openList [i];
-		Node::removeNodeFromVector (openList, currentNode); //remove current node from openList
-		closedList.insert (currentNode); //add currentNode to closedList
-										 //if currentNode is the same as endNode, it means that the path has been found, and it's time to retrace it
-		if (currentNode == endNode) {
-			retracePath (grid.gridOfNode [startNode.position.x] [startNode.position.y], grid.gridOfNode [endNode.position.x] [endNode.position.y]); //retrace pathFunction
+// moves an entry down the heap until both of it's children are not lower than it
+void OpenList::siftDown (int index) {
+	while (true) {
+		int lowest = index;
+		int left = index * 2 + 1, right = index * 2 + 2;
+		if (left < heap.size () && isLower (heap [left], heap [lowest]))
+			lowest = left;
+		if (right < heap.size () && isLower (heap [right], heap [lowest]))
+			lowest = right;
+		if (lowest == index)
 			return;
+		swapEntries (index, lowest);
+		index = lowest;
+	}
+}
+
+bool OpenList::empty () {
+	return heap.empty ();
+}
+
+int OpenList::size () {
+	return heap.size ();
+}
+
+bool OpenList::contains (Vector2 position) {
+	return handles [position.x] [position.y] != -1;
+}
+
+/**
+** Adds a position into the open list with the given costs
+** if the position is already in the open list, it's costs are updated instead, and it's moved up or down the heap to where the new costs belong
+**/
+void OpenList::push (Vector2 position, int fCost, int hCost) {
+	int index = handles [position.x] [position.y];
+	if (index == -1) {
+		Entry entry;
+		entry.fCost = fCost;
+		entry.hCost = hCost;
+		entry.position = position;
+		heap.push_back (entry);
+		index = heap.size () - 1;
+		handles [position.x] [position.y] = index;
+	} else {
+		heap [index].fCost = fCost;
+		heap [index].hCost = hCost;
+	}
+	siftDown (siftUp (index));
+}
+
+// removes and returns the position with the lowest fCost
+Vector2 OpenList::pop () {
+	Vector2 position = heap [0].position;
+	swapEntries (0, heap.size () - 1);
+	heap.pop_back ();
+	handles [position.x] [position.y] = -1;
+	if (!heap.empty ())
+		siftDown (0);
+	return position;
+}
+
+// removes a position from anywhere in the open list, the last entry takes it's place and is moved to where it belongs
+void OpenList::remove (Vector2 position) {
+	int index = handles [position.x] [position.y];
+	int last = heap.size () - 1;
+	swapEntries (index, last);
+	heap.pop_back ();
+	handles [position.x] [position.y] = -1;
+	if (index < last)
+		siftDown (siftUp (index));
+}
+
+// the position with the lowest fCost, without removing it
+Vector2 OpenList::top () {
+	return heap [0].position;
+}
+
+int OpenList::getTopFCost () {
+	return heap [0].fCost;
+}
+
+int OpenList::getTopHCost () {
+	return heap [0].hCost;
+}
+
+// empties the open list, only the handles of the positions still in the heap has to be reset
+void OpenList::clear () {
+	for (int i = 0; i < heap.size (); i++)
+		handles [heap [i].position.x] [heap [i].position.y] = -1;
+	heap.clear ();
+}
+
+// returns true if the position is inside the grid, and it's Node is walkable
+// x and y can be up to 1 outside the grid, where nothing is walkable
+bool Grid::isWalkable (int x, int y) {
+	int bitIndex = getBitIndex (x, y);
+	return (walkableBits [bitIndex >> 6] >> (bitIndex & 63)) & 1;
+}
+
+SearchState::SearchState () {
+	for (int i = 0; i < Grid::cellCount; i++)
+		generations [i] = 0;
+}
+
+// starts a new search, every cell stamped with an older generation is now not visited
+void SearchState::reset () {
+	openList.clear ();
+	generation++;
+	if (generation == 0) { // the generation wrapped around, so old stamps could match it again
+		for (int i = 0; i < Grid::cellCount; i++)
+			generations [i] = 0;
+		generation = 1;
+	}
+}
+
+bool SearchState::isVisited (int cell) {
+	return generations [cell] == generation;
+}
+
+bool SearchState::isClosed (int cell) {
+	return isVisited (cell) && closed [cell];
+}
+
+int SearchState::getGCost (int cell) {
+	return gCosts [cell];
+}
+
+int SearchState::getParent (int cell) {
+	return parents [cell];
+}
+
+// sets the gCost and parent of a cell, and marks it as visited in this search
+void SearchState::visit (int cell, int gCost, int parent) {
+	if (!isVisited (cell)) {
+		generations [cell] = generation;
+		closed [cell] = false;
+	}
+	gCosts [cell] = gCost;
+	parents [cell] = parent;
+}
+
+void SearchState::close (int cell) {
+	closed [cell] = true;
+}
+
+Grid PathFinder::grid; //initialzing the static grid
+
+thread_local SearchState PathFinder::threadSearchState;
+
+thread_local SearchState PathFinder::threadBackwardSearchState;
+
+bool PathFinder::verifyJumpPoint = false;
+
+bool PathFinder::landmarkHeuristic = false;
+
+std::atomic<int> PathFinder::jumpPointMismatches (0);
+
+// function to retrace path, following the parents in the SearchState from the endCell back to the startCell and adding them to the end of path, so other classes can use the information
+void PathFinder::retracePath (SearchState & state, int startCell, int endCell, std::vector<int> & path) {
+	int pathStart = path.size ();
+	for (int cell = endCell; cell != startCell; cell = state.getParent (cell))
+		path.push_back (cell);
+	std::reverse (path.begin () + pathStart, path.end ()); //reverse the path 
+}
+
+// searches with the SearchState of the calling thread
+void PathFinder::findPath (Vector2 currentPosition, Vector2 targetPosition) {
+	findPath (currentPosition, targetPosition, threadSearchState);
+}
+
+// searches the whole grid
+void PathFinder::findPath (Vector2 currentPosition, Vector2 targetPosition, SearchState & state) {
+	path.clear ();
+	findPathWithin (currentPosition, targetPosition, Vector2 (0, 0), Vector2 (screenWidth, screenHeight), state, path);
+}
+
+/**
+** Most important function, to find the shortest path from an currentPos to TargetPos, only going through the Nodes from lowerCorner up to(not including) upperCorner
+** if there's one, call retracePath function to add it to the end of path, and return true
+** The costs and parents of the Nodes are kept in the given SearchState, the grid is only used to check if a Node is walkable
+**/
+bool PathFinder::findPathWithin (Vector2 currentPosition, Vector2 targetPosition, Vector2 lowerCorner, Vector2 upperCorner, SearchState & state, std::vector<int> & path) {
+	startSearch (currentPosition, targetPosition, lowerCorner, upperCorner, state);
+	continueSearch (state, INT_MAX, path);
+	return state.found;
+}
+
+// starts a search like findPathWithin, without evaluating any Node yet, so it can be carried on a few Nodes at a time with continueSearch
+void PathFinder::startSearch (Vector2 currentPosition, Vector2 targetPosition, Vector2 lowerCorner, Vector2 upperCorner, SearchState & state) {
+	state.reset ();
+	state.startPosition = currentPosition;
+	state.targetPosition = targetPosition;
+	state.lowerCorner = lowerCorner;
+	state.upperCorner = upperCorner;
+	state.searching = true;
+	state.found = false;
+	int startCell = Grid::getCellIndex (currentPosition);
+	// the openList in the state is a heap that contains Node that should be evaluated(to check if the path through it will the be shortest), with the lowest fCost Node always on top
+	// and a Node is in the closed list once it has been evaluated, it's a flag in the state so checking it is a single array lookup
+	state.visit (startCell, 0, startCell);
+	int startHCost = Node::getDistance (currentPosition, targetPosition);
+	if (landmarkHeuristic && LandmarkMap::ready)
+		startHCost = std::max (startHCost, LandmarkMap::getLowerBound (startCell, Grid::getCellIndex (targetPosition)));
+	state.openList.push (currentPosition, startHCost, startHCost); //first add currentnode to openList, as it's the first node to be evaluated
+}
+
+/**
+** Evaluates up to maxExpansions Nodes of the search started with startSearch, and returns how many it evaluated
+** When the target is reached the path is added to the end of path and found is set, either way searching is false once the search is over
+**/
+int PathFinder::continueSearch (SearchState & state, int maxExpansions, std::vector<int> & path) {
+	int expansions = 0;
+	Vector2 targetPosition = state.targetPosition, lowerCorner = state.lowerCorner, upperCorner = state.upperCorner;
+	int targetCell = Grid::getCellIndex (targetPosition);
+	bool useLandmarks = landmarkHeuristic && LandmarkMap::ready;
+	//keep looping until there is no more Node in openList, which means all nodes has been evaluated
+	while (state.searching && expansions < maxExpansions) {
+		if (state.openList.empty ()) {
+			state.searching = false;
+			break;
+		}
+		Vector2 lowestPosition = state.openList.pop (); // take the Node in openList with the lowest fCost, if they are the same, the one with the lesser hCost(closer to targetNode)
+		int currentCell = Grid::getCellIndex (lowestPosition);
+		state.close (currentCell); //add currentNode to closedList
+		expansions++;
+		//if currentNode is the same as endNode, it means that the path has been found, and it's time to retrace it
+		if (lowestPosition == targetPosition) {
+			retracePath (state, Grid::getCellIndex (state.startPosition), currentCell, path); //retrace pathFunction
+			state.searching = false;
+			state.found = true;
+			break;
 		}
-		std::vector<Node> neighbours = grid.getNeighbours (currentNode); //get neighbour of currentNode and loop through the vector of Nodes
-		for (int i = 0; i < neighbours.size (); i++) {
-			if (!neighbours [i].walkable || closedList.count (neighbours [i])) //if node is not walkable or already being evaluated, skip it
+		// loop through the walkable neighbours of currentNode
+		int openDirections = grid.getOpenDirections (lowestPosition.x, lowestPosition.y);
+		int hCosts [8];
+		Grid::getNeighbourDistances (lowestPosition, targetPosition, hCosts);
+		for (int direction = 0; direction < 8; direction++) {
+			if (!(openDirections & 1 << direction))
+				continue;
+			Vector2 neighbour (lowestPosition.x + Grid::directionX [direction], lowestPosition.y + Grid::directionY [direction]);
+			if (neighbour.x < lowerCorner.x || neighbour.x >= upperCorner.x || neighbour.y < lowerCorner.y || neighbour.y >= upperCorner.y)
+				continue;
+			int neighbourCell = Grid::getCellIndex (neighbour);
+			if (state.isClosed (neighbourCell)) //if node is already being evaluated, skip it
 				continue;
 			//it's movement cost from itself to startNode
-			int newCostToNeighbour = currentNode.gCost + Node::getDistance (currentNode, neighbours [i]);
-			if (newCostToNeighbour < neighbours [i].gCost || !Node::nodeInList (openList, neighbours [i])) { //check if the path through neighbour[i] is the shortest, and whether it's in the openList
-				neighbours [i].gCost = newCostToNeighbour;
-				neighbours [i].hCost = Node::getDistance (neighbours [i], endNode);
-				neighbours [i].parentPosition = currentNode.position; //set currentNode as the neighbour's parent
-				grid.gridOfNode [neighbours [i].position.x] [neighbours [i].position.y] = neighbours [i]; //applying changes the Nodes in the grid
-				if (!Node::nodeInList (openList, neighbours [i]))
-					openList.push_back (neighbours [i]); // if Node is not in openList, add it in so it can evaluated
+			int newCostToNeighbour = state.getGCost (currentCell) + (Grid::directionX [direction] != 0 && Grid::directionY [direction] != 0 ? 14 : 10);
+			if (!state.isVisited (neighbourCell) || newCostToNeighbour < state.getGCost (neighbourCell)) { //check whether it's in the openList, and if the path through it is the shortest
+				state.visit (neighbourCell, newCostToNeighbour, currentCell); //set currentNode as the neighbour's parent
+				if (useLandmarks)
+					hCosts [direction] = std::max (hCosts [direction], LandmarkMap::getLowerBound (neighbourCell, targetCell));
+				state.openList.push (neighbour, newCostToNeighbour + hCosts [direction], hCosts [direction]); // add it in so it can evaluated, or move it up the openList if it's already in it
 			}
 		}
 	}
+	return expansions;
 }
 
-bool Graphics::screenUpdated = false;
+/**
+** Finds the cost from sourcePosition to every Node it can reach from lowerCorner up to(not including) upperCorner(Dijkstra's algorithm)
+** Afterwards, a Node was reached if it's visited in the state, and it's gCost is the cost from sourcePosition
+**/
+void PathFinder::floodWithin (Vector2 sourcePosition, Vector2 lowerCorner, Vector2 upperCorner, SearchState & state) {
+	state.reset ();
+	int sourceCell = Grid::getCellIndex (sourcePosition);
+	state.visit (sourceCell, 0, sourceCell);
+	state.openList.push (sourcePosition, 0, 0);
+	continueFloodWithin (lowerCorner, upperCorner, state);
+}
 
-char Graphics::screen [screenWidth] [screenHeight];
+// carries on floodWithin from the Nodes in the state's openList, with the gCosts they were visited with, so a flood can start from many sources at once
+void PathFinder::continueFloodWithin (Vector2 lowerCorner, Vector2 upperCorner, SearchState & state) {
+	while (!state.openList.empty ()) {
+		Vector2 lowestPosition = state.openList.pop ();
+		int currentCell = Grid::getCellIndex (lowestPosition);
+		state.close (currentCell);
+		int openDirections = grid.getOpenDirections (lowestPosition.x, lowestPosition.y);
+		for (int direction = 0; direction < 8; direction++) {
+			if (!(openDirections & 1 << direction))
+				continue;
+			Vector2 neighbour (lowestPosition.x + Grid::directionX [direction], lowestPosition.y + Grid::directionY [direction]);
+			if (neighbour.x < lowerCorner.x || neighbour.x >= upperCorner.x || neighbour.y < lowerCorner.y || neighbour.y >= upperCorner.y)
+				continue;
+			int neighbourCell = Grid::getCellIndex (neighbour);
+			if (state.isClosed (neighbourCell))
+				continue;
+			int newCostToNeighbour = state.getGCost (currentCell) + (Grid::directionX [direction] != 0 && Grid::directionY [direction] != 0 ? 14 : 10);
+			if (!state.isVisited (neighbourCell) || newCostToNeighbour < state.getGCost (neighbourCell)) {
+				state.visit (neighbourCell, newCostToNeighbour, currentCell);
+				state.openList.push (neighbour, newCostToNeighbour, 0);
+			}
+		}
+	}
+}
 
-Graphics::Graphics (Vector2 position, Vector2 dimensions) : position (position), dimensions (dimensions) {}
+// sums up the movement cost of a path, starting from startPosition
+int PathFinder::getPathCost (Vector2 startPosition, std::vector<int> & path) {
+	int cost = 0;
+	Vector2 previousPosition = startPosition;
+	for (int i = 0; i < path.size (); i++) {
+		Vector2 position = Grid::getCellPosition (path [i]);
+		cost += Node::getDistance (previousPosition, position);
+		previousPosition = position;
+	}
+	return cost;
+}
 
-// set position for the graphics
-void Graphics::setPosition (Vector2 position) {
-	clear ();
-	this->position = position;
+/**
+** The point after the given number of steps along the line from -> to, it's the same line Bresenham's algorithm draws, where every step moves one cell along the longer side,
+** and one along the shorter side only when the line has moved more than half a cell away. The point is found directly from the step, so a zombie walking the line only has to remember how far it is
+** A line of n steps costs 10 for each step along the longer side and 4 more for each step along the shorter side, which is the same as Node::getDistance, so it's always a shortest path
+**/
+Vector2 PathFinder::getLinePoint (Vector2 from, Vector2 to, int step) {
+	int differenceX = to.x - from.x, differenceY = to.y - from.y;
+	int length = std::max (std::abs (differenceX), std::abs (differenceY));
+	if (length == 0)
+		return from;
+	// rounds difference * step / length to the nearest whole number, halves away from zero so the line is the same in every direction
+	int x = differenceX * step, y = differenceY * step;
+	x = x >= 0 ? (2 * x + length) / (2 * length) : -((-2 * x + length) / (2 * length));
+	y = y >= 0 ? (2 * y + length) / (2 * length) : -((-2 * y + length) / (2 * length));
+	return Vector2 (from.x + x, from.y + y);
 }
 
-// extrude the graphics by the amount
-void Graphics::extrude (Direction direction, int amount) {
-	switch (direction) {
-		case up:
-			position.y -= amount;
-			dimensions.y += amount;
-			break;
-		case down:
-			dimensions.y += amount;
-			break;
-		case left:
-			position.x -= amount;
-			dimensions.x += amount;
-			break;
-		case right:
-			dimensions.x += amount;
-			break;
+// checks if every point on the line from -> to is walkable, if it is a zombie can walk straight along it
+bool PathFinder::hasLineOfSight (Vector2 from, Vector2 to) {
+	int length = std::max (std::abs (to.x - from.x), std::abs (to.y - from.y));
+	for (int step = 1; step <= length; step++) {
+		Vector2 point = getLinePoint (from, to, step);
+		if (!grid.isWalkable (point.x, point.y))
+			return false;
 	}
+	return true;
 }
 
-// clear the graphics
-void Graphics::clear () {
-	for (int x = position.x; x < position.x + dimensions.x; x++)
-		for (int y = position.y; y < position.y + dimensions.y; y++)
-			screen [x] [y] = ' ';
-	screenUpdated = true;
+/**
+** Turns a path of cells starting from startPosition into waypoints, keeping only the cells where the path has to turn
+** Each cell is skipped if the next one is in line of sight of the last waypoint, so the lines between the waypoints are walkable and never cost more than the path did
+**/
+void PathFinder::pullString (Vector2 startPosition, std::vector<int> & path) {
+	int waypointCount = 0;
+	Vector2 lastWaypoint = startPosition;
+	for (int i = 0; i < path.size (); i++) {
+		if (i + 1 < path.size () && hasLineOfSight (lastWaypoint, Grid::getCellPosition (path [i + 1])))
+			continue;
+		path [waypointCount++] = path [i];
+		lastWaypoint = Grid::getCellPosition (path [i]);
+	}
+	path.resize (waypointCount);
 }
 
-// load the graphics to be rendered and adds it to the screen array, then sets screenUpdated flag to true.
-void Graphics::render (char graphics []) {
-	int i = 0;
+/**
+** Moves from position in the direction(directionX, directionY) until it finds a jump point, and stores it in jumpPoint
+** A jump point is the target, or a Node with a forced neighbour(a neighbour that can only be reached shortest through this Node because of a wall beside it)
+** When moving diagonally, the Node is also a jump point if moving horizontally or vertically from it finds one
+** Returns false if a wall or the end of the grid was hit first
+**/
+bool PathFinder::jump (Vector2 position, int directionX, int directionY, Vector2 targetPosition, Vector2 & jumpPoint) {
+	int x = position.x, y = position.y;
+	while (true) {
+		x += directionX;
+		y += directionY;
+		if (!grid.isWalkable (x, y))
+			return false;
+		if (Vector2 (x, y) == targetPosition) {
+			jumpPoint = Vector2 (x, y);
+			return true;
+		}
+		bool forced;
+		if (directionX != 0 && directionY != 0)
+			forced = (grid.isWalkable (x - directionX, y + directionY) && !grid.isWalkable (x - directionX, y)) ||
+				(grid.isWalkable (x + directionX, y - directionY) && !grid.isWalkable (x, y - directionY));
+		else if (directionX != 0)
+			forced = (grid.isWalkable (x + directionX, y + 1) && !grid.isWalkable (x, y + 1)) ||
+				(grid.isWalkable (x + directionX, y - 1) && !grid.isWalkable (x, y - 1));
+		else
+			forced = (grid.isWalkable (x + 1, y + directionY) && !grid.isWalkable (x + 1, y)) ||
+				(grid.isWalkable (x - 1, y + directionY) && !grid.isWalkable (x - 1, y));
+		Vector2 straightJumpPoint;
+		if (!forced && directionX != 0 && directionY != 0)
+			forced = jump (Vector2 (x, y), directionX, 0, targetPosition, straightJumpPoint) || jump (Vector2 (x, y), 0, directionY, targetPosition, straightJumpPoint);
+		if (forced) {
+			jumpPoint = Vector2 (x, y);
+			return true;
+		}
+	}
+}
+
+/**
+** Finds the jump points reachable from node, stores them in successors, and returns how many were found
+** Only the directions that a shortest path coming from node's parent could continue in are searched(the natural and forced neighbours),
+** every direction is searched from the startNode, as it has no parent
+**/
+int PathFinder::getJumpPointSuccessors (SearchState & state, int cell, int startCell, Vector2 targetPosition, Vector2 successors []) {
+	int directions [8] [2];
+	int directionCount = 0;
+	Vector2 position = Grid::getCellPosition (cell);
+	int x = position.x, y = position.y;
+	if (cell == startCell) {
+		for (int directionX = -1; directionX <= 1; directionX++)
+			for (int directionY = -1; directionY <= 1; directionY++)
+				if (directionX != 0 || directionY != 0) {
+					directions [directionCount] [0] = directionX;
+					directions [directionCount++] [1] = directionY;
+				}
+	} else {
+		Vector2 parentPosition = Grid::getCellPosition (state.getParent (cell));
+		int directionX = (x > parentPosition.x) - (x < parentPosition.x);
+		int directionY = (y > parentPosition.y) - (y < parentPosition.y);
+		int natural [3] [2] = { { directionX, directionY }, { directionX, 0 }, { 0, directionY } };
+		int naturalCount = directionX != 0 && directionY != 0 ? 3 : 1;
+		for (int i = 0; i < naturalCount; i++) {
+			directions [directionCount] [0] = natural [i] [0];
+			directions [directionCount++] [1] = natural [i] [1];
+		}
+		if (directionX != 0 && directionY != 0) {
+			if (!grid.isWalkable (x - directionX, y)) {
+				directions [directionCount] [0] = -directionX;
+				directions [directionCount++] [1] = directionY;
+			}
+			if (!grid.isWalkable (x, y - directionY)) {
+				directions [directionCount] [0] = directionX;
+				directions [directionCount++] [1] = -directionY;
+			}
+		} else if (directionX != 0) {
+			for (int side = -1; side <= 1; side += 2)
+				if (!grid.isWalkable (x, y + side)) {
+					directions [directionCount] [0] = directionX;
+					directions [directionCount++] [1] = side;
+				}
+		} else {
+			for (int side = -1; side <= 1; side += 2)
+				if (!grid.isWalkable (x + side, y)) {
+					directions [directionCount] [0] = side;
+					directions [directionCount++] [1] = directionY;
+				}
+		}
+	}
+	int successorCount = 0;
+	for (int i = 0; i < directionCount; i++)
+		if (jump (position, directions [i] [0], directions [i] [1], targetPosition, successors [successorCount]))
+			successorCount++;
+	return successorCount;
+}
+
+// retraces the jump points from endCell back to startCell, and fills in every Node between them, so the path has the same shape as an A* path
+void PathFinder::retraceJumpPoints (SearchState & state, int startCell, int endCell) {
+	for (int cell = endCell; cell != startCell; cell = state.getParent (cell)) {
+		Vector2 currentPosition = Grid::getCellPosition (cell);
+		Vector2 parentPosition = Grid::getCellPosition (state.getParent (cell));
+		int directionX = (parentPosition.x > currentPosition.x) - (parentPosition.x < currentPosition.x);
+		int directionY = (parentPosition.y > currentPosition.y) - (parentPosition.y < currentPosition.y);
+		for (Vector2 position = currentPosition; position != parentPosition; position = Vector2 (position.x + directionX, position.y + directionY))
+			path.push_back (Grid::getCellIndex (position));
+	}
+	std::reverse (path.begin (), path.end ());
+}
+
+// searches with the SearchState of the calling thread
+void PathFinder::findJumpPointPath (Vector2 currentPosition, Vector2 targetPosition) {
+	findJumpPointPath (currentPosition, targetPosition, threadSearchState);
+}
+
+/**
+** Finds the shortest path from currentPosition to targetPosition with Jump Point Search
+** Works the same way as findPath, except that the Nodes added into the openList are the jump points found from the current Node instead of it's neighbours
+**/
+void PathFinder::findJumpPointPath (Vector2 currentPosition, Vector2 targetPosition, SearchState & state) {
+	path.clear ();
+	state.reset ();
+	int startCell = Grid::getCellIndex (currentPosition);
+	state.visit (startCell, 0, startCell);
+	int startHCost = Node::getDistance (currentPosition, targetPosition);
+	state.openList.push (currentPosition, startHCost, startHCost);
+	while (!state.openList.empty ()) {
+		Vector2 lowestPosition = state.openList.pop ();
+		int currentCell = Grid::getCellIndex (lowestPosition);
+		state.close (currentCell);
+		if (lowestPosition == targetPosition) {
+			retraceJumpPoints (state, startCell, currentCell);
+			break;
+		}
+		Vector2 successors [8];
+		int successorCount = getJumpPointSuccessors (state, currentCell, startCell, targetPosition, successors);
+		for (int i = 0; i < successorCount; i++) {
+			int successorCell = Grid::getCellIndex (successors [i]);
+			if (state.isClosed (successorCell))
+				continue;
+			int newCostToSuccessor = state.getGCost (currentCell) + Node::getDistance (lowestPosition, successors [i]); // jump points are in a straight or diagonal line, so the distance is the exact movement cost
+			if (!state.isVisited (successorCell) || newCostToSuccessor < state.getGCost (successorCell)) {
+				state.visit (successorCell, newCostToSuccessor, currentCell);
+				int hCost = Node::getDistance (successors [i], targetPosition);
+				state.openList.push (successors [i], newCostToSuccessor + hCost, hCost);
+			}
+		}
+	}
+	if (verifyJumpPoint) {
+		PathFinder aStarPathFinder;
+		aStarPathFinder.findPath (currentPosition, targetPosition);
+		if (getPathCost (currentPosition, path) != getPathCost (currentPosition, aStarPathFinder.path) || path.empty () != aStarPathFinder.path.empty ())
+			jumpPointMismatches++;
+	}
+}
+
+// searches with the SearchStates of the calling thread
+void PathFinder::findBidirectionalPath (Vector2 currentPosition, Vector2 targetPosition) {
+	findBidirectionalPath (currentPosition, targetPosition, threadSearchState, threadBackwardSearchState);
+}
+
+/**
+** Finds the shortest path with two A* searches at the same time, one forwards from currentPosition to targetPosition, and one backwards from targetPosition to currentPosition
+** Each time, the search with the smaller openList evaluates a Node, so when one side is stuck in a dead end the other side does most of the work.
+** Whenever a search reaches a Node the other one has reached, the path through that Node is a candidate, and the cheapest one is kept.
+** The searches can stop once the cheapest candidate costs no more than the lowest fCost in either openList,
+** as every path that hasn't been found yet goes through a Node in both openLists, and costs at least that Node's fCost
+**/
+void PathFinder::findBidirectionalPath (Vector2 currentPosition, Vector2 targetPosition, SearchState & forward, SearchState & backward) {
+	path.clear ();
+	int startCell = Grid::getCellIndex (currentPosition), targetCell = Grid::getCellIndex (targetPosition);
+	if (startCell == targetCell)
+		return;
+	forward.reset ();
+	backward.reset ();
+	forward.visit (startCell, 0, startCell);
+	backward.visit (targetCell, 0, targetCell);
+	int startHCost = Node::getDistance (currentPosition, targetPosition);
+	forward.openList.push (currentPosition, startHCost, startHCost);
+	backward.openList.push (targetPosition, startHCost, startHCost);
+	int bestCost = INT_MAX, meetingCell = -1;
+	while (!forward.openList.empty () && !backward.openList.empty ()) {
+		if (bestCost <= std::max (forward.openList.getTopFCost (), backward.openList.getTopFCost ()))
+			break;
+		bool forwards = forward.openList.size () <= backward.openList.size ();
+		SearchState & state = forwards ? forward : backward;
+		SearchState & otherState = forwards ? backward : forward;
+		Vector2 goal = forwards ? targetPosition : currentPosition;
+		Vector2 lowestPosition = state.openList.pop ();
+		int currentCell = Grid::getCellIndex (lowestPosition);
+		state.close (currentCell);
+		int openDirections = grid.getOpenDirections (lowestPosition.x, lowestPosition.y);
+		int hCosts [8];
+		Grid::getNeighbourDistances (lowestPosition, goal, hCosts);
+		for (int direction = 0; direction < 8; direction++) {
+			if (!(openDirections & 1 << direction))
+				continue;
+			Vector2 neighbour (lowestPosition.x + Grid::directionX [direction], lowestPosition.y + Grid::directionY [direction]);
+			int neighbourCell = Grid::getCellIndex (neighbour);
+			if (state.isClosed (neighbourCell))
+				continue;
+			int newCostToNeighbour = state.getGCost (currentCell) + (Grid::directionX [direction] != 0 && Grid::directionY [direction] != 0 ? 14 : 10);
+			if (!state.isVisited (neighbourCell) || newCostToNeighbour < state.getGCost (neighbourCell)) {
+				state.visit (neighbourCell, newCostToNeighbour, currentCell);
+				state.openList.push (neighbour, newCostToNeighbour + hCosts [direction], hCosts [direction]);
+				if (otherState.isVisited (neighbourCell) && newCostToNeighbour + otherState.getGCost (neighbourCell) < bestCost) {
+					bestCost = newCostToNeighbour + otherState.getGCost (neighbourCell);
+					meetingCell = neighbourCell;
+				}
+			}
+		}
+	}
+	if (meetingCell == -1)
+		return;
+	// the forward search's parents lead back to the start, and the backward search's parents lead on to the target
+	retracePath (forward, startCell, meetingCell, path);
+	for (int cell = meetingCell; cell != targetCell;) {
+		cell = backward.getParent (cell);
+		path.push_back (cell);
+	}
+}
+
+// searches with the backend of the pathStrategy, the flow field is not a search, so it falls back to A*
+void PathFinder::findPath (Vector2 currentPosition, Vector2 targetPosition, PathStrategy pathStrategy) {
+	clearWaypoints ();
+	if (pathStrategy == hierarchical)
+		findHierarchicalPath (currentPosition, targetPosition);
+	else if (pathStrategy == jumpPoint)
+		findJumpPointPath (currentPosition, targetPosition);
+	else if (pathStrategy == bidirectional)
+		findBidirectionalPath (currentPosition, targetPosition);
+	else if (pathStrategy == incremental) {
+		if (!incrementalPlanner)
+			incrementalPlanner.reset (new IncrementalPlanner ());
+		incrementalPlanner->findPath (currentPosition, targetPosition, path);
+	} else
+		findPath (currentPosition, targetPosition);
+}
+
+/**
+** Plans a path on the HierarchicalMap, which must be up to date, and only refines the first part of it(up to the first entrance) into path
+** the rest is refined by refineNextSegment when it's needed
+**/
+void PathFinder::findHierarchicalPath (Vector2 currentPosition, Vector2 targetPosition) {
+	path.clear ();
+	waypoints.clear ();
+	nextWaypoint = 0;
+	refinedPosition = currentPosition;
+	if (HierarchicalMap::findAbstractPath (currentPosition, targetPosition, threadSearchState, waypoints))
+		refineNextSegment (path);
+}
+
+// drops the rest of a hierarchical path, for when the path is replaced by one found somewhere else
+void PathFinder::clearWaypoints () {
+	waypoints.clear ();
+	nextWaypoint = 0;
+}
+
+/**
+** Refines the path from where the refined part ends to the next waypoint and adds it to the end of refinedPath, returns false if there are no waypoints left
+** Two waypoints are either in the same cluster, so the search stays inside that cluster, or an entrance and it's neighbour across the border, one step apart
+**/
+bool PathFinder::refineNextSegment (std::vector<int> & refinedPath) {
+	if (nextWaypoint >= waypoints.size ())
+		return false;
+	Vector2 waypoint = waypoints [nextWaypoint++];
+	int cluster = HierarchicalMap::getCluster (refinedPosition);
+	if (cluster == HierarchicalMap::getCluster (waypoint)) {
+		Vector2 lowerCorner, upperCorner;
+		HierarchicalMap::getClusterBounds (cluster, lowerCorner, upperCorner);
+		findPathWithin (refinedPosition, waypoint, lowerCorner, upperCorner, threadSearchState, refinedPath);
+	} else
+		refinedPath.push_back (Grid::getCellIndex (waypoint));
+	refinedPosition = waypoint;
+	return true;
+}
+
+std::vector<HierarchicalMap::Cluster> HierarchicalMap::clusters;
+
+int HierarchicalMap::entranceOfCell [Grid::cellCount];
+
+int HierarchicalMap::gridCreation = -1;
+
+int HierarchicalMap::seenChanges = 0;
+
+SearchState HierarchicalMap::buildState;
+
+const int HierarchicalMap::unreachable; // defined here as well, because vectors of costs are filled with it by reference
+
+Vector2 HierarchicalMap::fieldTarget;
+
+int HierarchicalMap::fieldGridCreation = -1;
+
+int HierarchicalMap::fieldSeenChanges = 0;
+
+int HierarchicalMap::fieldCostLimit = 0;
+
+int HierarchicalMap::fieldUpdates = 0;
+
+int HierarchicalMap::rebuiltClusters = 0;
+
+int HierarchicalMap::getCluster (Vector2 position) {
+	return position.x / clusterSize * clustersHigh + position.y / clusterSize;
+}
+
+// the cells of a cluster are from lowerCorner up to(not including) upperCorner
+void HierarchicalMap::getClusterBounds (int cluster, Vector2 & lowerCorner, Vector2 & upperCorner) {
+	lowerCorner = Vector2 (cluster / clustersHigh * clusterSize, cluster % clustersHigh * clusterSize);
+	upperCorner = Vector2 (std::min (lowerCorner.x + clusterSize, screenWidth), std::min (lowerCorner.y + clusterSize, screenHeight));
+}
+
+/**
+** Adds the entrances on one side of a cluster, the cells from firstCell going in the direction step, facing the cells across the border in the direction across
+** Each run of walkable cells facing walkable cells gets an entrance in the middle, or one at each end if it's a long run, so paths are not forced through a single cell.
+** A cell that can only cross diagonally, because the cells beside the diagonal step are both walls, is an entrance of it's own. If either of those was walkable,
+** the step could go round through it and cross straight instead. It's decided from the same four cells on both sides, so the cell across gets an entrance as well
+**/
+void HierarchicalMap::addBorderEntrances (int cluster, Vector2 firstCell, Vector2 step, Vector2 across) {
+	Vector2 lowerCorner, upperCorner;
+	getClusterBounds (cluster, lowerCorner, upperCorner);
+	int length = step.x != 0 ? upperCorner.x - lowerCorner.x : upperCorner.y - lowerCorner.y;
+	int runStart = -1;
+	for (int i = 0; i <= length; i++) {
+		Vector2 cell (firstCell.x + step.x * i, firstCell.y + step.y * i);
+		bool open = i < length && PathFinder::grid.isWalkable (cell.x, cell.y) && PathFinder::grid.isWalkable (cell.x + across.x, cell.y + across.y);
+		for (int side = -1; side <= 1 && i < length && !open; side += 2) {
+			Grid & grid = PathFinder::grid; // cells just off the screen are never walkable, so they need no checks
+			if (grid.isWalkable (cell.x, cell.y) && grid.isWalkable (cell.x + across.x + step.x * side, cell.y + across.y + step.y * side)
+				&& !grid.isWalkable (cell.x + across.x, cell.y + across.y) && !grid.isWalkable (cell.x + step.x * side, cell.y + step.y * side))
+				addEntrance (cluster, cell);
+		}
+		if (open && runStart == -1)
+			runStart = i;
+		if (open || runStart == -1)
+			continue;
+		int runEnd = i - 1;
+		int entrances [2] = { (runStart + runEnd) / 2, -1 };
+		if (runEnd - runStart + 1 >= 6) {
+			entrances [0] = runStart;
+			entrances [1] = runEnd;
+		}
+		for (int j = 0; j < 2 && entrances [j] != -1; j++)
+			addEntrance (cluster, Vector2 (firstCell.x + step.x * entrances [j], firstCell.y + step.y * entrances [j]));
+		runStart = -1;
+	}
+}
+
+// adds the cell to the cluster's entrances, unless it already is one
+void HierarchicalMap::addEntrance (int cluster, Vector2 entrance) {
+	int entranceCell = Grid::getCellIndex (entrance);
+	if (entranceOfCell [entranceCell] != -1)
+		return; // a corner cell can be an entrance on two sides
+	entranceOfCell [entranceCell] = clusters [cluster].entrances.size ();
+	clusters [cluster].entrances.push_back (entrance);
+}
+
+// finds the entrances of other clusters one step, straight or diagonal, from the entrance at position, and the cost of the step to each, returns how many there are
+int HierarchicalMap::getCrossings (Vector2 position, Vector2 crossings [], int costs []) {
+	int cluster = getCluster (position);
+	int crossingCount = 0;
+	for (int direction = 0; direction < 8; direction++) {
+		Vector2 neighbour (position.x + Grid::directionX [direction], position.y + Grid::directionY [direction]);
+		if (neighbour.x < 0 || neighbour.x >= screenWidth || neighbour.y < 0 || neighbour.y >= screenHeight)
+			continue;
+		if (getCluster (neighbour) == cluster || entranceOfCell [Grid::getCellIndex (neighbour)] == -1)
+			continue;
+		crossings [crossingCount] = neighbour;
+		costs [crossingCount++] = Grid::directionX [direction] != 0 && Grid::directionY [direction] != 0 ? 14 : 10;
+	}
+	return crossingCount;
+}
+
+/**
+** Builds a cluster again, finds the entrances on each of it's four sides, then floods the cluster from each entrance to find the costs to the others
+** Entrances only depend on the cells on both sides of the border, so the neighbour across a border finds the same entrances on it's side
+**/
+void HierarchicalMap::buildCluster (int cluster) {
+	Cluster & clusterToBuild = clusters [cluster];
+	for (int i = 0; i < clusterToBuild.entrances.size (); i++)
+		entranceOfCell [Grid::getCellIndex (clusterToBuild.entrances [i])] = -1;
+	clusterToBuild.entrances.clear ();
+	Vector2 lowerCorner, upperCorner;
+	getClusterBounds (cluster, lowerCorner, upperCorner);
+	if (lowerCorner.y > 0)
+		addBorderEntrances (cluster, lowerCorner, Vector2 (1, 0), Vector2 (0, -1));
+	if (upperCorner.y < screenHeight)
+		addBorderEntrances (cluster, Vector2 (lowerCorner.x, upperCorner.y - 1), Vector2 (1, 0), Vector2 (0, 1));
+	if (lowerCorner.x > 0)
+		addBorderEntrances (cluster, lowerCorner, Vector2 (0, 1), Vector2 (-1, 0));
+	if (upperCorner.x < screenWidth)
+		addBorderEntrances (cluster, Vector2 (upperCorner.x - 1, lowerCorner.y), Vector2 (0, 1), Vector2 (1, 0));
+	int entranceCount = clusterToBuild.entrances.size ();
+	clusterToBuild.costs.assign (entranceCount * entranceCount, unreachable);
+	for (int i = 0; i < entranceCount; i++) {
+		PathFinder::floodWithin (clusterToBuild.entrances [i], lowerCorner, upperCorner, buildState);
+		for (int j = 0; j < entranceCount; j++) {
+			int cell = Grid::getCellIndex (clusterToBuild.entrances [j]);
+			if (buildState.isVisited (cell))
+				clusterToBuild.costs [i * entranceCount + j] = buildState.getGCost (cell);
+		}
+	}
+	rebuiltClusters++;
+}
+
+/**
+** Brings the map up to date with the grid, every cluster is built if the grid was created again, otherwise only the clusters with changed cells,
+** and the neighbours across the border when a changed cell is on one. Must not be called while paths are being searched on other threads
+**/
+void HierarchicalMap::update () {
+	Grid & grid = PathFinder::grid;
+	if (gridCreation != grid.creation) {
+		gridCreation = grid.creation;
+		seenChanges = grid.changedCells.size ();
+		clusters.assign (clustersWide * clustersHigh, Cluster ());
+		for (int i = 0; i < Grid::cellCount; i++)
+			entranceOfCell [i] = -1;
+		for (int cluster = 0; cluster < clusters.size (); cluster++)
+			buildCluster (cluster);
+		return;
+	}
+	if (seenChanges == grid.changedCells.size ())
+		return;
+	std::vector<bool> dirty (clusters.size (), false);
+	for (; seenChanges < grid.changedCells.size (); seenChanges++) {
+		Vector2 position = Grid::getCellPosition (grid.changedCells [seenChanges]);
+		for (int x = -1; x <= 1; x++) {
+			for (int y = -1; y <= 1; y++) {
+				Vector2 neighbour (position.x + x, position.y + y);
+				if (neighbour.x >= 0 && neighbour.x < screenWidth && neighbour.y >= 0 && neighbour.y < screenHeight)
+					dirty [getCluster (neighbour)] = true;
+			}
+		}
+	}
+	for (int cluster = 0; cluster < clusters.size (); cluster++)
+		if (dirty [cluster])
+			buildCluster (cluster);
+}
+
+/**
+** Plans a path from currentPosition to targetPosition on the graph of entrances, and stores the entrances it goes through(then the target) in waypoints
+** The start and target are connected to the entrances of their clusters by flooding those clusters, and if they share a cluster and can reach each other inside it,
+** the target is the only waypoint. The graph is searched with A*, the Nodes are the entrance cells so the state works the same as for a grid search
+**/
+bool HierarchicalMap::findAbstractPath (Vector2 currentPosition, Vector2 targetPosition, SearchState & state, std::vector<Vector2> & waypoints) {
+	int startCluster = getCluster (currentPosition), targetCluster = getCluster (targetPosition);
+	Vector2 lowerCorner, upperCorner;
+	getClusterBounds (startCluster, lowerCorner, upperCorner);
+	PathFinder::floodWithin (currentPosition, lowerCorner, upperCorner, state);
+	if (startCluster == targetCluster && state.isVisited (Grid::getCellIndex (targetPosition))) {
+		waypoints.push_back (targetPosition);
+		return true;
+	}
+	std::vector<int> startCosts (clusters [startCluster].entrances.size (), unreachable);
+	for (int i = 0; i < startCosts.size (); i++) {
+		int cell = Grid::getCellIndex (clusters [startCluster].entrances [i]);
+		if (state.isVisited (cell))
+			startCosts [i] = state.getGCost (cell);
+	}
+	getClusterBounds (targetCluster, lowerCorner, upperCorner);
+	PathFinder::floodWithin (targetPosition, lowerCorner, upperCorner, state);
+	std::vector<int> targetCosts (clusters [targetCluster].entrances.size (), unreachable);
+	for (int i = 0; i < targetCosts.size (); i++) {
+		int cell = Grid::getCellIndex (clusters [targetCluster].entrances [i]);
+		if (state.isVisited (cell))
+			targetCosts [i] = state.getGCost (cell);
+	}
+	state.reset ();
+	int startCell = Grid::getCellIndex (currentPosition);
+	state.visit (startCell, 0, startCell);
+	int startHCost = Node::getDistance (currentPosition, targetPosition);
+	state.openList.push (currentPosition, startHCost, startHCost);
+	while (!state.openList.empty ()) {
+		Vector2 lowestPosition = state.openList.pop ();
+		int currentCell = Grid::getCellIndex (lowestPosition);
+		state.close (currentCell);
+		if (lowestPosition == targetPosition) {
+			int waypointStart = waypoints.size ();
+			for (int cell = currentCell; cell != startCell; cell = state.getParent (cell))
+				waypoints.push_back (Grid::getCellPosition (cell));
+			std::reverse (waypoints.begin () + waypointStart, waypoints.end ());
+			return true;
+		}
+		// gather the edges going out of this Node, as a position and a cost
+		Vector2 successors [maxSuccessors];
+		int successorCosts [maxSuccessors];
+		int successorCount = 0;
+		int cluster = getCluster (lowestPosition);
+		Cluster & currentCluster = clusters [cluster];
+		int entrance = entranceOfCell [currentCell];
+		if (lowestPosition == currentPosition)
+			for (int i = 0; i < startCosts.size (); i++)
+				if (startCosts [i] != unreachable) {
+					successors [successorCount] = currentCluster.entrances [i];
+					successorCosts [successorCount++] = startCosts [i];
+				}
+		if (entrance != -1) {
+			int entranceCount = currentCluster.entrances.size ();
+			for (int i = 0; i < entranceCount; i++)
+				if (i != entrance && currentCluster.costs [entrance * entranceCount + i] != unreachable) {
+					successors [successorCount] = currentCluster.entrances [i];
+					successorCosts [successorCount++] = currentCluster.costs [entrance * entranceCount + i];
+				}
+			successorCount += getCrossings (lowestPosition, successors + successorCount, successorCosts + successorCount);
+			if (cluster == targetCluster && targetCosts [entrance] != unreachable) {
+				successors [successorCount] = targetPosition;
+				successorCosts [successorCount++] = targetCosts [entrance];
+			}
+		}
+		for (int i = 0; i < successorCount; i++) {
+			int successorCell = Grid::getCellIndex (successors [i]);
+			if (state.isClosed (successorCell))
+				continue;
+			int newCostToSuccessor = state.getGCost (currentCell) + successorCosts [i];
+			if (!state.isVisited (successorCell) || newCostToSuccessor < state.getGCost (successorCell)) {
+				state.visit (successorCell, newCostToSuccessor, currentCell);
+				int hCost = Node::getDistance (successors [i], targetPosition);
+				state.openList.push (successors [i], newCostToSuccessor + hCost, hCost);
+			}
+		}
+	}
+	return false;
+}
+
+/**
+** Brings the coarse flow field up to date for targetPosition, it's the cost from every entrance to the target on the graph of entrances, found with Dijkstra's algorithm from the target
+** (the costs between entrances are the same both ways). The target is connected to the entrances of it's cluster by flooding it, like findAbstractPath does.
+** The search stops once the cheapest entrance left costs more than costLimit, so only the part of the map that's needed is calculated, the entrances past it keep the first cost found or stay unreachable.
+** It's only calculated again when the target, the costLimit or the walls changed, and must not be called while paths are being searched on other threads
+**/
+void HierarchicalMap::updateField (Vector2 targetPosition, int costLimit) {
+	update ();
+	if (fieldTarget == targetPosition && fieldCostLimit == costLimit && fieldGridCreation == gridCreation && fieldSeenChanges == seenChanges)
+		return;
+	fieldTarget = targetPosition;
+	fieldCostLimit = costLimit;
+	fieldGridCreation = gridCreation;
+	fieldSeenChanges = seenChanges;
+	fieldUpdates++;
+	for (int cluster = 0; cluster < clusters.size (); cluster++)
+		clusters [cluster].fieldCosts.assign (clusters [cluster].entrances.size (), unreachable);
+	int targetCluster = getCluster (targetPosition);
+	Vector2 lowerCorner, upperCorner;
+	getClusterBounds (targetCluster, lowerCorner, upperCorner);
+	PathFinder::floodWithin (targetPosition, lowerCorner, upperCorner, buildState);
+	OpenList & openList = buildState.openList;
+	openList.clear ();
+	for (int i = 0; i < clusters [targetCluster].entrances.size (); i++) {
+		int cell = Grid::getCellIndex (clusters [targetCluster].entrances [i]);
+		if (buildState.isVisited (cell)) {
+			clusters [targetCluster].fieldCosts [i] = buildState.getGCost (cell);
+			openList.push (clusters [targetCluster].entrances [i], buildState.getGCost (cell), 0);
+		}
+	}
+	while (!openList.empty ()) {
+		Vector2 current = openList.pop ();
+		Cluster & currentCluster = clusters [getCluster (current)];
+		int entrance = entranceOfCell [Grid::getCellIndex (current)];
+		int entranceCount = currentCluster.entrances.size ();
+		int cost = currentCluster.fieldCosts [entrance];
+		if (cost > costLimit)
+			break;
+		for (int i = 0; i < entranceCount; i++) {
+			int newCost = cost + currentCluster.costs [entrance * entranceCount + i];
+			if (currentCluster.costs [entrance * entranceCount + i] != unreachable && newCost < currentCluster.fieldCosts [i]) {
+				currentCluster.fieldCosts [i] = newCost;
+				openList.push (currentCluster.entrances [i], newCost, 0);
+			}
+		}
+		Vector2 crossings [8];
+		int crossingCosts [8];
+		int crossingCount = getCrossings (current, crossings, crossingCosts);
+		for (int i = 0; i < crossingCount; i++) {
+			int & neighbourCost = clusters [getCluster (crossings [i])].fieldCosts [entranceOfCell [Grid::getCellIndex (crossings [i])]];
+			if (cost + crossingCosts [i] < neighbourCost) {
+				neighbourCost = cost + crossingCosts [i];
+				openList.push (crossings [i], neighbourCost, 0);
+			}
+		}
+	}
+}
+
+/**
+** The cost from the cell at position to the target of the coarse flow field, going round the walls inside it's cluster to the entrance that's cheapest from there.
+** The costs of a cluster are found for all it's cells at once, with a flood from every entrance the field reaches(and from the target in the target's cluster) starting at the field's cost,
+** the first time a zombie asks for one of them after the field was calculated. Returns unreachable if the field doesn't reach the cell
+**/
+int HierarchicalMap::getFieldCost (Vector2 position) {
+	int cluster = getCluster (position);
+	Cluster & currentCluster = clusters [cluster];
+	Vector2 lowerCorner, upperCorner;
+	getClusterBounds (cluster, lowerCorner, upperCorner);
+	int clusterHeight = upperCorner.y - lowerCorner.y;
+	if (currentCluster.cellCostsField != fieldUpdates) {
+		currentCluster.cellCostsField = fieldUpdates;
+		currentCluster.cellCosts.assign ((upperCorner.x - lowerCorner.x) * clusterHeight, unreachable);
+		buildState.reset ();
+		OpenList & openList = buildState.openList;
+		openList.clear ();
+		if (cluster == getCluster (fieldTarget) && PathFinder::grid.isWalkable (fieldTarget.x, fieldTarget.y)) {
+			int cell = Grid::getCellIndex (fieldTarget);
+			buildState.visit (cell, 0, cell);
+			openList.push (fieldTarget, 0, 0);
+		}
+		for (int i = 0; i < currentCluster.entrances.size (); i++) {
+			int cost = currentCluster.fieldCosts [i];
+			int cell = Grid::getCellIndex (currentCluster.entrances [i]);
+			if (cost == unreachable || (buildState.isVisited (cell) && buildState.getGCost (cell) <= cost))
+				continue;
+			buildState.visit (cell, cost, cell);
+			openList.push (currentCluster.entrances [i], cost, 0);
+		}
+		PathFinder::continueFloodWithin (lowerCorner, upperCorner, buildState);
+		for (int x = lowerCorner.x; x < upperCorner.x; x++)
+			for (int y = lowerCorner.y; y < upperCorner.y; y++)
+				if (buildState.isVisited (Grid::getCellIndex (Vector2 (x, y))))
+					currentCluster.cellCosts [(x - lowerCorner.x) * clusterHeight + y - lowerCorner.y] = buildState.getGCost (Grid::getCellIndex (Vector2 (x, y)));
+	}
+	return currentCluster.cellCosts [(position.x - lowerCorner.x) * clusterHeight + position.y - lowerCorner.y];
+}
+
+/**
+** Finds where a zombie at position goes next on the coarse flow field, it's the neighbour with the lowest cost to the target(getFieldCost), in it's own cluster or across the border.
+** The costs go down along the way round the walls of every cluster, and they go down by the cost of the step, so following them never loops and never leads into a wall.
+** Returns false if the field doesn't reach the zombie's cell, or it's already at the target
+**/
+bool HierarchicalMap::getFieldWaypoint (Vector2 position, Vector2 & waypoint) {
+	int lowestCost = getFieldCost (position);
+	if (lowestCost == unreachable)
+		return false;
+	bool found = false;
+	int openDirections = PathFinder::grid.getOpenDirections (position.x, position.y);
+	for (int direction = 0; direction < 8; direction++) {
+		if (!(openDirections & 1 << direction))
+			continue;
+		Vector2 neighbour (position.x + Grid::directionX [direction], position.y + Grid::directionY [direction]);
+		int cost = getFieldCost (neighbour);
+		if (cost < lowestCost) {
+			lowestCost = cost;
+			waypoint = neighbour;
+			found = true;
+		}
+	}
+	return found;
+}
+
+std::vector<int> LandmarkMap::landmarks;
+
+std::vector<int> LandmarkMap::costs;
+
+unsigned int LandmarkMap::mapHash = 0;
+
+int LandmarkMap::gridCreation = -1;
+
+int LandmarkMap::seenChanges = 0;
+
+SearchState LandmarkMap::buildState;
+
+bool LandmarkMap::ready = false;
+
+double LandmarkMap::calculateMilliseconds = 0;
+
+const int LandmarkMap::unreachable;
+
+// an FNV-1a hash of the size of the grid and every cell's walkable flag
+unsigned int LandmarkMap::hashMap () {
+	unsigned int hash = 2166136261u;
+	int values [2] = { screenWidth, screenHeight };
+	for (int i = 0; i < 2; i++)
+		for (int byte = 0; byte < 4; byte++)
+			hash = (hash ^ ((values [i] >> byte * 8) & 255)) * 16777619u;
+	for (int x = 0; x < screenWidth; x++)
+		for (int y = 0; y < screenHeight; y++)
+			hash = (hash ^ PathFinder::grid.isWalkable (x, y)) * 16777619u;
+	return hash;
+}
+
+std::string LandmarkMap::getFileName (unsigned int hash) {
+	std::ostringstream fileName;
+	fileName << "landmarks_" << std::hex << hash << ".bin";
+	return fileName.str ();
+}
+
+// reads the tables saved for the map with this hash, returns false if there is no file, or it's not for a map of this size
+bool LandmarkMap::load (unsigned int hash) {
+	std::ifstream file (getFileName (hash).c_str (), std::ios::binary);
+	if (!file)
+		return false;
+	int header [3];
+	file.read ((char *) header, sizeof (header));
+	if (!file || header [0] != screenWidth || header [1] != screenHeight || header [2] != landmarkCount)
+		return false;
+	landmarks.resize (landmarkCount);
+	costs.resize (landmarkCount * Grid::cellCount);
+	file.read ((char *) &landmarks [0], landmarks.size () * sizeof (int));
+	file.read ((char *) &costs [0], costs.size () * sizeof (int));
+	return (bool) file;
+}
+
+// writes the tables to the file for the current map, if the file can't be written they are just calculated again next time
+void LandmarkMap::save () {
+	std::ofstream file (getFileName (mapHash).c_str (), std::ios::binary);
+	if (!file)
+		return;
+	int header [3] = { screenWidth, screenHeight, landmarkCount };
+	file.write ((char *) header, sizeof (header));
+	file.write ((char *) &landmarks [0], landmarks.size () * sizeof (int));
+	file.write ((char *) &costs [0], costs.size () * sizeof (int));
+}
+
+/**
+** Picks the landmarks and finds the cost from each of them to every cell
+** Each landmark is the cell furthest from all the landmarks picked before it(the first one is furthest from the first walkable cell), so they end up spread around the edges of the map.
+** A cell no landmark can reach counts as the furthest, so every part of the map cut off from the rest gets a landmark too, while there are some left
+**/
+void LandmarkMap::calculate () {
+	landmarks.clear ();
+	costs.assign (landmarkCount * Grid::cellCount, unreachable);
+	std::vector<int> closestLandmarkCost (Grid::cellCount, unreachable);
+	int firstCell = -1;
+	for (int cell = 0; cell < Grid::cellCount && firstCell == -1; cell++)
+		if (PathFinder::grid.isWalkable (Grid::getCellPosition (cell).x, Grid::getCellPosition (cell).y))
+			firstCell = cell;
+	if (firstCell == -1)
+		return;
+	PathFinder::floodWithin (Grid::getCellPosition (firstCell), Vector2 (0, 0), Vector2 (screenWidth, screenHeight), buildState);
+	int nextLandmark = firstCell;
+	for (int cell = 0; cell < Grid::cellCount; cell++)
+		if (buildState.isVisited (cell) && buildState.getGCost (cell) > buildState.getGCost (nextLandmark))
+			nextLandmark = cell;
+	while (landmarks.size () < landmarkCount) {
+		int landmark = landmarks.size ();
+		landmarks.push_back (nextLandmark);
+		PathFinder::floodWithin (Grid::getCellPosition (nextLandmark), Vector2 (0, 0), Vector2 (screenWidth, screenHeight), buildState);
+		int furthestCost = -1;
+		for (int cell = 0; cell < Grid::cellCount; cell++) {
+			Vector2 position = Grid::getCellPosition (cell);
+			if (!PathFinder::grid.isWalkable (position.x, position.y))
+				continue;
+			if (buildState.isVisited (cell)) {
+				costs [cell * landmarkCount + landmark] = buildState.getGCost (cell);
+				closestLandmarkCost [cell] = std::min (closestLandmarkCost [cell], buildState.getGCost (cell));
+			}
+			if (closestLandmarkCost [cell] > furthestCost) {
+				furthestCost = closestLandmarkCost [cell];
+				nextLandmark = cell;
+			}
+		}
+	}
+}
+
+/**
+** Brings the tables up to date with the grid, they are loaded from the file for this map if there is one, otherwise calculated and saved
+** Must not be called while paths are being searched on other threads
+**/
+void LandmarkMap::update () {
+	Grid & grid = PathFinder::grid;
+	if (gridCreation == grid.creation && seenChanges == grid.changedCells.size ())
+		return;
+	gridCreation = grid.creation;
+	seenChanges = grid.changedCells.size ();
+	unsigned int hash = hashMap ();
+	if (ready && hash == mapHash)
+		return;
+	mapHash = hash;
+	calculateMilliseconds = 0;
+	if (!load (hash)) {
+		clock_t start = clock ();
+		calculate ();
+		calculateMilliseconds = (clock () - start) * 1000.0 / CLOCKS_PER_SEC;
+		save ();
+	}
+	ready = true;
+}
+
+// the lowest the cost from cell to targetCell can be, the biggest difference between their costs from a landmark
+int LandmarkMap::getLowerBound (int cell, int targetCell) {
+	const int * cellCosts = &costs [cell * landmarkCount];
+	const int * targetCosts = &costs [targetCell * landmarkCount];
+	int lowerBound = 0;
+	for (int landmark = 0; landmark < landmarkCount; landmark++)
+		if (cellCosts [landmark] != unreachable && targetCosts [landmark] != unreachable)
+			lowerBound = std::max (lowerBound, std::abs (cellCosts [landmark] - targetCosts [landmark]));
+	return lowerBound;
+}
+
+// the bytes used by the tables
+int LandmarkMap::getMemoryUsage () {
+	return (landmarks.capacity () + costs.capacity ()) * sizeof (int);
+}
+
+std::atomic<int> IncrementalPlanner::replans (0);
+
+std::atomic<int> IncrementalPlanner::restarts (0);
+
+std::atomic<int> IncrementalPlanner::totalExpansions (0);
+
+IncrementalPlanner::IncrementalPlanner () {
+	for (int i = 0; i < Grid::cellCount; i++)
+		generations [i] = 0;
+}
+
+int IncrementalPlanner::getGCost (int cell) {
+	return generations [cell] == generation ? gCosts [cell] : unreachable;
+}
+
+int IncrementalPlanner::getRhsCost (int cell) {
+	return generations [cell] == generation ? rhsCosts [cell] : unreachable;
+}
+
+void IncrementalPlanner::setCosts (int cell, int gCost, int rhsCost) {
+	generations [cell] = generation;
+	gCosts [cell] = gCost;
+	rhsCosts [cell] = rhsCost;
+}
+
+// the cost of moving between two neighbouring positions, unreachable if either of them is not walkable
+int IncrementalPlanner::getMoveCost (Vector2 from, Vector2 to) {
+	if (!PathFinder::grid.isWalkable (from.x, from.y) || !PathFinder::grid.isWalkable (to.x, to.y))
+		return unreachable;
+	return from.x != to.x && from.y != to.y ? 14 : 10;
+}
+
+// number of Nodes evaluated by the last findPath
+int IncrementalPlanner::getExpansions () {
+	return expansions;
+}
+
+/**
+** Recalculates the rhsCost of a Node from it's neighbours, then puts it in the openList if it's gCost is different(inconsistent),
+** or takes it out of the openList if they are the same. The key of a Node is it's lowest cost plus the distance to the target, then the lowest cost to break ties
+**/
+void IncrementalPlanner::updateNode (Vector2 position) {
+	int cell = Grid::getCellIndex (position);
+	int rhsCost = getRhsCost (cell);
+	if (position != root) {
+		rhsCost = unreachable;
+		for (int x = -1; x <= 1; x++) {
+			for (int y = -1; y <= 1; y++) {
+				Vector2 neighbour (position.x + x, position.y + y);
+				if ((x == 0 && y == 0) || neighbour.x < 0 || neighbour.x >= screenWidth || neighbour.y < 0 || neighbour.y >= screenHeight)
+					continue;
+				int moveCost = getMoveCost (position, neighbour);
+				int neighbourGCost = getGCost (Grid::getCellIndex (neighbour));
+				if (moveCost != unreachable && neighbourGCost != unreachable)
+					rhsCost = std::min (rhsCost, neighbourGCost + moveCost);
+			}
+		}
+	}
+	int gCost = getGCost (cell);
+	setCosts (cell, gCost, rhsCost);
+	if (gCost != rhsCost) {
+		int lowestCost = std::min (gCost, rhsCost);
+		openList.push (position, lowestCost + Node::getDistance (target, position) + keyModifier, lowestCost);
+	} else if (openList.contains (position))
+		openList.remove (position);
+}
+
+void IncrementalPlanner::updateNeighbours (Vector2 position) {
+	for (int x = -1; x <= 1; x++) {
+		for (int y = -1; y <= 1; y++) {
+			Vector2 neighbour (position.x + x, position.y + y);
+			if ((x == 0 && y == 0) || neighbour.x < 0 || neighbour.x >= screenWidth || neighbour.y < 0 || neighbour.y >= screenHeight)
+				continue;
+			updateNode (neighbour);
+		}
+	}
+}
+
+/**
+** Evaluates Nodes from the openList until the target's costs are consistent, and no Node in the openList could still give it a shorter path
+** A Node whose gCost is higher than it's rhsCost has found a shorter path, so it's gCost is lowered and it's neighbours are updated,
+** a Node whose gCost is lower has lost it's path(a wall was added), so it's gCost is raised to unreachable and it and it's neighbours are updated
+**/
+void IncrementalPlanner::computeShortestPath () {
+	int targetCell = Grid::getCellIndex (target);
+	while (!openList.empty ()) {
+		int targetLowestCost = std::min (getGCost (targetCell), getRhsCost (targetCell));
+		int targetKey = targetLowestCost + keyModifier; // the distance from the target to itself is 0
+		bool topIsLower = openList.getTopFCost () < targetKey || (openList.getTopFCost () == targetKey && openList.getTopHCost () < targetLowestCost);
+		if (!topIsLower && getGCost (targetCell) == getRhsCost (targetCell))
+			break;
+		Vector2 position = openList.top ();
+		int cell = Grid::getCellIndex (position);
+		int gCost = getGCost (cell), rhsCost = getRhsCost (cell);
+		int lowestCost = std::min (gCost, rhsCost);
+		int newKey = lowestCost + Node::getDistance (target, position) + keyModifier;
+		expansions++;
+		if (openList.getTopFCost () < newKey || (openList.getTopFCost () == newKey && openList.getTopHCost () < lowestCost))
+			openList.push (position, newKey, lowestCost); // the key was made before the target moved, so it's only moved to where it belongs now
+		else if (gCost > rhsCost) {
+			setCosts (cell, rhsCost, rhsCost);
+			openList.remove (position);
+			updateNeighbours (position);
+		} else {
+			setCosts (cell, unreachable, rhsCost);
+			updateNode (position);
+			updateNeighbours (position);
+		}
+	}
+}
+
+// throws away the old search and starts a new one rooted at rootPosition
+void IncrementalPlanner::restart (Vector2 rootPosition, Vector2 targetPosition) {
+	generation++;
+	if (generation == 0) {
+		for (int i = 0; i < Grid::cellCount; i++)
+			generations [i] = 0;
+		generation = 1;
+	}
+	openList.clear ();
+	root = rootPosition;
+	target = targetPosition;
+	keyModifier = 0;
+	gridCreation = PathFinder::grid.creation;
+	seenChanges = PathFinder::grid.changedCells.size ();
+	int rootCell = Grid::getCellIndex (root);
+	setCosts (rootCell, unreachable, 0);
+	openList.push (root, Node::getDistance (target, root), 0);
+	restarts++;
+}
+
+/**
+** Finds the shortest path from currentPosition to targetPosition into path, with the same shape as an A* path
+** If the search is still rooted at currentPosition and the grid was not created again, it's repaired for the target's new position
+** and any cells that changed since the last replan, otherwise it's started again
+**/
+void IncrementalPlanner::findPath (Vector2 currentPosition, Vector2 targetPosition, std::vector<int> & path) {
+	path.clear ();
+	expansions = 0;
+	if (generation == 0 || currentPosition != root || gridCreation != PathFinder::grid.creation)
+		restart (currentPosition, targetPosition);
+	else {
+		replans++;
+		keyModifier += Node::getDistance (target, targetPosition);
+		target = targetPosition;
+		for (; seenChanges < PathFinder::grid.changedCells.size (); seenChanges++) {
+			Vector2 changedPosition = Grid::getCellPosition (PathFinder::grid.changedCells [seenChanges]);
+			updateNode (changedPosition);
+			updateNeighbours (changedPosition);
+		}
+	}
+	computeShortestPath ();
+	totalExpansions += expansions;
+	// follow the neighbours with the lowest cost back from the target to the zombie, then reverse it
+	Vector2 position = target;
+	if (getGCost (Grid::getCellIndex (position)) == unreachable)
+		return;
+	while (position != root && path.size () < Grid::cellCount) {
+		path.push_back (Grid::getCellIndex (position));
+		Vector2 nextPosition = position;
+		int lowestCost = unreachable;
+		for (int x = -1; x <= 1; x++) {
+			for (int y = -1; y <= 1; y++) {
+				Vector2 neighbour (position.x + x, position.y + y);
+				if ((x == 0 && y == 0) || neighbour.x < 0 || neighbour.x >= screenWidth || neighbour.y < 0 || neighbour.y >= screenHeight)
+					continue;
+				int moveCost = getMoveCost (position, neighbour);
+				int neighbourGCost = getGCost (Grid::getCellIndex (neighbour));
+				if (moveCost != unreachable && neighbourGCost != unreachable && neighbourGCost + moveCost < lowestCost) {
+					lowestCost = neighbourGCost + moveCost;
+					nextPosition = neighbour;
+				}
+			}
+		}
+		if (nextPosition == position) {
+			path.clear ();
+			return;
+		}
+		position = nextPosition;
+	}
+	std::reverse (path.begin (), path.end ());
+}
+
+int FlowField::costs [screenWidth] [screenHeight];
+
+OpenList FlowField::openList;
+
+Vector2 FlowField::target;
+
+bool FlowField::calculated = false;
+
+/**
+** Calculates the cost from every walkable position to the target, starting from the target and spreading outwards(Dijkstra's algorithm)
+** The same movement costs as the A* pathfinding are used(10 for horizontal and vertical, 14 for diagonal), so zombies take the same shortest paths
+** Nothing is done if the field was already calculated for this target
+**/
+void FlowField::calculate (Vector2 targetPosition) {
+	if (calculated && target == targetPosition)
+		return;
+	target = targetPosition;
+	calculated = true;
+	for (int x = 0; x < screenWidth; x++)
+		for (int y = 0; y < screenHeight; y++)
+			costs [x] [y] = unreachable;
+	openList.clear ();
+	costs [target.x] [target.y] = 0;
+	openList.push (target, 0, 0);
+	while (!openList.empty ()) {
+		Vector2 current = openList.pop ();
+		int openDirections = PathFinder::grid.getOpenDirections (current.x, current.y); // the Nodes where a whole zombie fits, like the searches
+		for (int direction = 0; direction < 8; direction++) {
+			if (!(openDirections & 1 << direction))
+				continue;
+			Vector2 neighbour (current.x + Grid::directionX [direction], current.y + Grid::directionY [direction]);
+			int newCost = costs [current.x] [current.y] + (Grid::directionX [direction] != 0 && Grid::directionY [direction] != 0 ? 14 : 10);
+			if (newCost < costs [neighbour.x] [neighbour.y]) {
+				costs [neighbour.x] [neighbour.y] = newCost;
+				openList.push (neighbour, newCost, 0);
+			}
+		}
+	}
+}
+
+// forces the field to be recalculated the next time, called when the walkable areas change
+void FlowField::invalidate () {
+	calculated = false;
+}
+
+/**
+** Finds the neighbour of position that the shortest path to the target goes through(lowest cost after adding the cost of moving to it), and stores it in nextStep
+** returns false if there is no step to take, when position is the target or the target can't be reached from it
+**/
+bool FlowField::getNextStep (Vector2 position, Vector2 & nextStep) {
+	int lowestCost = costs [position.x] [position.y];
+	bool found = false;
+	for (int x = -1; x <= 1; x++) {
+		for (int y = -1; y <= 1; y++) {
+			Vector2 neighbour (position.x + x, position.y + y);
+			if ((x == 0 && y == 0) || neighbour.x < 0 || neighbour.x >= screenWidth || neighbour.y < 0 || neighbour.y >= screenHeight)
+				continue;
+			if (costs [neighbour.x] [neighbour.y] == unreachable)
+				continue;
+			int costThroughNeighbour = costs [neighbour.x] [neighbour.y] + (x != 0 && y != 0 ? 14 : 10);
+			if (costThroughNeighbour <= lowestCost) {
+				lowestCost = costThroughNeighbour;
+				nextStep = neighbour;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+// creates the worker threads, there is always at least one
+PathWorkerPool::PathWorkerPool (int threadCount) : nextRequest (0) {
+	if (threadCount < 1)
+		threadCount = 1;
+	for (int i = 0; i < threadCount; i++)
+		workers.push_back (std::thread (&PathWorkerPool::work, this));
+}
+
+// waits for the current batch, then stops and joins every worker
+PathWorkerPool::~PathWorkerPool () {
+	wait ();
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		stopping = true;
+	}
+	batchStarted.notify_all ();
+	for (int i = 0; i < workers.size (); i++)
+		workers [i].join ();
+}
+
+int PathWorkerPool::getThreadCount () {
+	return workers.size ();
+}
+
+// adds a request to the next batch
+void PathWorkerPool::add (PathRequest request) {
+	pendingRequests.push_back (request);
+}
+
+/**
+** Starts working on every request added since the last batch, without waiting for them to finish
+** The previous batch is waited for first, as the workers must be done with it before it's replaced
+**/
+void PathWorkerPool::start () {
+	wait ();
+	if (pendingRequests.empty ())
+		return;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		requests.swap (pendingRequests); // swapping keeps the memory of both vectors, so they stop allocating once they are big enough
+		pendingRequests.clear ();
+		requestCount = requests.size ();
+		unfinishedRequests = requestCount;
+		nextRequest = 0;
+		batch++;
+	}
+	batchStarted.notify_all ();
+}
+
+// blocks until every request of the current batch has been searched, and no worker is still looking at it
+void PathWorkerPool::wait () {
+	std::unique_lock<std::mutex> lock (mutex);
+	batchFinished.wait (lock, [this] { return unfinishedRequests == 0 && activeWorkers == 0; });
+}
+
+/**
+** The loop of each worker thread, it sleeps until a batch is started, then keeps taking the next request nobody has taken yet until there are none left
+** A worker joins a batch by counting itself as active at the same time it reads which batch it is, so the batch can't be replaced while it's still taking requests
+**/
+void PathWorkerPool::work () {
+	int seenBatch = 0;
+	while (true) {
+		int count;
+		{
+			std::unique_lock<std::mutex> lock (mutex);
+			batchStarted.wait (lock, [this, seenBatch] { return stopping || batch != seenBatch; });
+			if (stopping)
+				return;
+			seenBatch = batch;
+			count = requestCount;
+			activeWorkers++;
+		}
+		int finished = 0;
+		for (int i = nextRequest++; i < count; i = nextRequest++) {
+			PathRequest & request = requests [i];
+			request.pathFinder->findPath (request.startPosition, request.targetPosition, request.pathStrategy);
+			finished++;
+		}
+		{
+			std::lock_guard<std::mutex> lock (mutex);
+			unfinishedRequests -= finished;
+			activeWorkers--;
+		}
+		batchFinished.notify_all ();
+	}
+}
+
+bool Graphics::screenUpdated = false;
+
+char Graphics::screen [screenWidth] [screenHeight];
+
+Graphics::Graphics (Vector2 position, Vector2 dimensions) : position (position), dimensions (dimensions) {}
+
+// set position for the graphics
+void Graphics::setPosition (Vector2 position) {
+	clear ();
+	this->position = position;
+}
+
+// extrude the graphics by the amount
+void Graphics::extrude (Direction direction, int amount) {
+	switch (direction) {
+		case up:
+			position.y -= amount;
+			dimensions.y += amount;
+			break;
+		case down:
+			dimensions.y += amount;
+			break;
+		case left:
+			position.x -= amount;
+			dimensions.x += amount;
+			break;
+		case right:
+			dimensions.x += amount;
+			break;
+	}
+}
+
+// clear the graphics
+void Graphics::clear () {
+	for (int x = position.x; x < position.x + dimensions.x; x++)
+		for (int y = position.y; y < position.y + dimensions.y; y++)
+			screen [x] [y] = ' ';
+	screenUpdated = true;
+}
+
+// load the graphics to be rendered and adds it to the screen array, then sets screenUpdated flag to true.
+void Graphics::render (char graphics []) {
+	int i = 0;
 	for (int y = position.y; y < position.y + dimensions.y; y++) {
 		for (int x = position.x; x < position.x + dimensions.x; x++) {
 			if (screen [x] [y] = ' ') {
@@ -427,30 +2494,82 @@ void Graphics::render (char graphics []) {
 			}
 		}
 	}
-	screenUpdated = true;
+	screenUpdated = true;
+}
+
+void Graphics::render (char graphic) {
+	for (int y = position.y; y < position.y + dimensions.y; y++)
+		for (int x = position.x; x < position.x + dimensions.x; x++)
+			screen [x] [y] = graphic;
+	screenUpdated = true;
+}
+
+// static array of colliders, stores all the colliders that are alive, a removed collider's slot is given to the next one created
+std::vector<Collider *> Collider::colliders;
+
+std::vector<ColliderKind> Collider::kinds;
+
+std::vector<int> Collider::generations;
+
+std::vector<int> Collider::freeSlots;
+
+const int Collider::slotBits;
+
+/* the collision responses, in the order of ColliderKind. A zombie touching another zombie, or the player touching the attack, does nothing,
+so the collider that moved isn't put in the collision matrix there*/
+const Collider::CollisionHandler Collider::collisionHandlers [colliderKindCount] [colliderKindCount] = {
+	{ Wall::collidedWithWall, NULL, NULL, NULL },
+	{ Zombie::collidedWithWall, NULL, Zombie::collidedWithPlayer, Zombie::collidedWithAttack },
+	{ Player::collidedWithWall, Player::collidedWithZombie, NULL, NULL },
+	{ Attack::collidedWithWall, Attack::collidedWithZombie, NULL, NULL }
+};
+
+// stores collision information in this 2d array
+int Collider::collisionMatrix [screenWidth] [screenHeight];
+
+// constructor for Collider, it takes a free slot if there is one, or adds a new one
+Collider::Collider (Vector2 position, Vector2 dimensions, ColliderKind kind) : kind (kind), position (position), dimensions (dimensions) {
+	int slot;
+	if (freeSlots.empty ()) {
+		slot = colliders.size ();
+		assert (slot + 1 < 1 << slotBits); // slot + 1 has to fit below the generation in the id, that's a million colliders alive at once
+		colliders.push_back (this);
+		kinds.push_back (kind);
+		generations.push_back (0);
+	} else {
+		slot = freeSlots.back ();
+		freeSlots.pop_back ();
+		colliders [slot] = this;
+		kinds [slot] = kind;
+	}
+	id = (generations [slot] << slotBits) | (slot + 1);
 }
 
-void Graphics::render (char graphic) {
-	for (int y = position.y; y < position.y + dimensions.y; y++)
-		for (int x = position.x; x < position.x + dimensions.x; x++)
-			screen [x] [y] = graphic;
-	screenUpdated = true;
+// destructor, takes the collider out of the collision matrix and frees it's slot, handles to it are out of date from then on
+Collider::~Collider () {
+	clear ();
+	int slot = getSlot (id);
+	colliders [slot] = NULL;
+	generations [slot] = (generations [slot] + 1) & generationMask;
+	freeSlots.push_back (slot);
 }
 
-// the static id to keep track of the next id for the collider.
-int Collider::currentId = 1;
-
-// static array of colliders, stores all the colliders that is created
-std::vector<Collider *> Collider::colliders;
+// the slot in colliders of a handle
+int Collider::getSlot (int id) {
+	return (id & ((1 << slotBits) - 1)) - 1;
+}
 
-// stores collision information in this 2d array
-int Collider::collisionMatrix [screenWidth] [screenHeight];
+// the collider with the handle(as stored in the collision matrix), or NULL if it was removed
+Collider * Collider::getCollider (int id) {
+	int slot = getSlot (id);
+	if (id == 0 || slot >= colliders.size () || generations [slot] != id >> slotBits)
+		return NULL;
+	return colliders [slot];
+}
 
-// constructor for Collider.
-Collider::Collider (Vector2 position, Vector2 dimensions) : position (position), dimensions (dimensions) {
-	colliders.push_back (this);
-	id = currentId;
-	currentId++;
+// the number of slots, used or free, it only grows with the number of colliders alive at the same time
+int Collider::getColliderSlots () {
+	return colliders.size ();
 }
 
 // getter for the colliders position
@@ -458,6 +2577,16 @@ Vector2 Collider::getPosition () {
 	return position;
 }
 
+// getter for the id, it's a handle that Collider::getCollider turns back into the collider for as long as it's alive
+int Collider::getId () {
+	return id;
+}
+
+// getter for kind
+ColliderKind Collider::getKind () {
+	return kind;
+}
+
 // sets the position
 void Collider::setPosition (Vector2 position) {
 	previousPosition = this->position;
@@ -465,13 +2594,18 @@ void Collider::setPosition (Vector2 position) {
 	checkCollisionMatrix ();
 }
 
-// checks for collisions, then calls the collided fucntion is collided with something
+// checks for collisions, then calls the collision handler for the kinds of the two colliders if collided with something
 void Collider::checkCollisionMatrix () {
 	for (int x = position.x; x < position.x + dimensions.x; x++) {
 		for (int y = position.y; y < position.y + dimensions.y; y++) {
 			int point = collisionMatrix [x] [y];
 			if (point != 0 && point != id) {
-				collided (colliders [point - 1]);
+				int slot = getSlot (point);
+				if (generations [slot] != point >> slotBits) // left behind by a removed collider, so it's as good as empty
+					continue;
+				CollisionHandler collisionHandler = collisionHandlers [kind] [kinds [slot]];
+				if (collisionHandler)
+					collisionHandler (this, colliders [slot]);
 				return;
 			}
 		}
@@ -503,131 +2637,895 @@ void Collider::clear () {
 				collisionMatrix [x] [y] = 0;
 }
 
-/* constructor, creates a zombie and spawns it.*/
-Zombie::Zombie (Vector2 position, Vector2 playerPosition) : Collider (Vector2 (position), Vector2 (3, 3)), graphics (position, Vector2 (3, 3)) {
-	moveTimer = 0;
+// true if no collider is in the rectangle at position, of the given dimensions, which must be inside the screen
+bool Collider::isAreaEmpty (Vector2 position, Vector2 dimensions) {
+	for (int x = position.x; x < position.x + dimensions.x; x++)
+		for (int y = position.y; y < position.y + dimensions.y; y++)
+			if (collisionMatrix [x] [y] != 0)
+				return false;
+	return true;
+}
+
+// constructs an object in a free slot with the arguments given, a new block is only made when there are no free slots left
+template <class T>
+template <class... Arguments>
+T * ObjectPool<T>::acquire (Arguments &&... arguments) {
+	if (!firstFree) {
+		blocks.push_back (std::unique_ptr<Slot []> (new Slot [blockSize]));
+		for (int i = 0; i < blockSize; i++) {
+			blocks.back () [i].nextFree = firstFree;
+			firstFree = &blocks.back () [i];
+		}
+	}
+	Slot * slot = firstFree;
+	firstFree = slot->nextFree;
+	used++;
+	return new (&slot->object) T (std::forward<Arguments> (arguments)...);
+}
+
+// destroys an object acquired from the pool, and puts it's slot on the free list
+template <class T>
+void ObjectPool<T>::release (T * object) {
+	if (!object)
+		return;
+	object->~T ();
+	Slot * slot = reinterpret_cast<Slot *> (object);
+	slot->nextFree = firstFree;
+	firstFree = slot;
+	used--;
+}
+
+template <class T>
+int ObjectPool<T>::getUsed () {
+	return used;
+}
+
+template <class T>
+int ObjectPool<T>::getCapacity () {
+	return blocks.size () * blockSize;
+}
+
+// the smallest size class with room for length cells
+int PathArena::getSizeClass (int length) {
+	int sizeClass = 0;
+	while (minimumCapacity << sizeClass < length)
+		sizeClass++;
+	return sizeClass;
+}
+
+// takes a free block with room for length cells, or adds a new one to the end of cells if there are none
+int PathArena::allocate (int length) {
+	int sizeClass = getSizeClass (length);
+	int handle;
+	if (!freeBlocks [sizeClass].empty ()) {
+		handle = freeBlocks [sizeClass].back ();
+		freeBlocks [sizeClass].pop_back ();
+	} else {
+		Block block;
+		block.offset = cells.size ();
+		block.sizeClass = sizeClass;
+		cells.resize (cells.size () + (minimumCapacity << sizeClass));
+		handle = blocks.size ();
+		blocks.push_back (block);
+	}
+	blocks [handle].length = 0;
+	return handle;
+}
+
+/**
+** Replaces the path of handle with path, and returns the handle it's now stored at
+** The block is reused if the path fits in it, an empty path releases the block and returns none
+**/
+int PathArena::assign (int handle, std::vector<int> & path) {
+	if (path.empty ()) {
+		release (handle);
+		return none;
+	}
+	if (handle == none || minimumCapacity << blocks [handle].sizeClass < path.size ()) {
+		release (handle);
+		handle = allocate (path.size ());
+	}
+	std::copy (path.begin (), path.end (), cells.begin () + blocks [handle].offset);
+	blocks [handle].length = path.size ();
+	return handle;
+}
+
+// adds path to the end of the path of handle, moving it to a bigger block if it doesn't fit, and returns the handle it's now stored at
+int PathArena::append (int handle, std::vector<int> & path) {
+	if (handle == none)
+		return assign (handle, path);
+	int length = blocks [handle].length + path.size ();
+	if (minimumCapacity << blocks [handle].sizeClass < length) {
+		int newHandle = allocate (length);
+		std::copy (cells.begin () + blocks [handle].offset, cells.begin () + blocks [handle].offset + blocks [handle].length, cells.begin () + blocks [newHandle].offset);
+		blocks [newHandle].length = blocks [handle].length;
+		release (handle);
+		handle = newHandle;
+	}
+	std::copy (path.begin (), path.end (), cells.begin () + blocks [handle].offset + blocks [handle].length);
+	blocks [handle].length = length;
+	return handle;
+}
+
+// puts the block of handle on the free list of it's size
+void PathArena::release (int handle) {
+	if (handle == none)
+		return;
+	blocks [handle].length = 0;
+	freeBlocks [blocks [handle].sizeClass].push_back (handle);
+}
+
+int PathArena::getLength (int handle) {
+	return handle == none ? 0 : blocks [handle].length;
+}
+
+// the cell at index in the path of handle
+int PathArena::getCell (int handle, int index) {
+	return cells [blocks [handle].offset + index];
+}
+
+// the bytes used by the arena, not counting the free lists
+int PathArena::getMemoryUsage () {
+	return cells.capacity () * sizeof (int) + blocks.capacity () * sizeof (Block);
+}
+
+/* constructor, creates a zombie and spawns it. It's path is calculated by the ZombieManager, only if it's in the near tier*/
+Zombie::Zombie (Vector2 position) : Collider (Vector2 (position), Vector2 (3, 3), zombieCollider), graphics (position, Vector2 (3, 3)) {
 	setPosition (position);
 	if (spawnSuccessful) {
 		graphics.setPosition (position);
 		graphics.render (defaultPose);
-		calculatePath (playerPosition);
 	}
 }
 
-/* called when the zombie dies, it clears the colliders and graphics of the zombie,
+// destructor, gives back the path of a zombie that didn't die(it was put in a wall, or the game ended)
+Zombie::~Zombie () {
+	pathArena.release (path);
+}
+
+/* called when the zombie dies, it gives back it's path to the pathArena, clears the colliders and graphics of the zombie,
 and then sets a flag for dead to true*/
 void Zombie::die () {
+	pathArena.release (path);
+	path = PathArena::none;
 	clear (previousPosition);
 	clear (position);
 	graphics.clear ();
 	dead = true;
+	deaths++;
 	Game::score++;
 }
 
-void Zombie::calculatePath (Vector2 targetPosition) {
+/* finds the way to the targetPosition with the given strategy, with a flow field the shared field is only calculated
+if it's not up to date, and the zombie will read it's next step from it when it moves*/
+void Zombie::calculatePath (Vector2 targetPosition, PathStrategy pathStrategy) {
 	if (dead)
 		return;
-	pathFinder.findPath (position, targetPosition);
-	path = pathFinder.path;
-	pathIndex = 0;
+	this->pathStrategy = pathStrategy;
+	target = targetPosition;
+	if (pathStrategy == flowField) {
+		FlowField::calculate (targetPosition);
+		return;
+	}
+	if (followLineOfSight (targetPosition))
+		return;
+	if (pathStrategy == hierarchical)
+		HierarchicalMap::update ();
+	if (PathFinder::landmarkHeuristic)
+		LandmarkMap::update ();
+	pathFinder.findPath (position, targetPosition, pathStrategy);
+	setPath (pathFinder.path);
 }
 
-void Zombie::collided (Collider * collider) {
-	if (dynamic_cast<Attack *> (collider))
-		die ();
-	else if (Player * player = dynamic_cast<Player *> (collider)) {
-		player->hurt ();
-		clear (previousPosition);
-		updateCollisionMatrix ();
-	} else if (dynamic_cast<Wall *> (collider)) {
-		clear ();
-		dead = true;
-		spawnSuccessful = false;
+/* same as calculatePath, except the search is added to the pathWorkerPool's next batch instead of done straight away,
+the zombie keeps it's old path until receivePath is called after the batch is done*/
+void Zombie::requestPath (Vector2 targetPosition, PathStrategy pathStrategy, PathWorkerPool & pathWorkerPool) {
+	if (dead)
+		return;
+	if (pathStrategy == flowField) {
+		calculatePath (targetPosition, pathStrategy);
+		return;
 	}
+	this->pathStrategy = pathStrategy;
+	if (followLineOfSight (targetPosition))
+		return;
+	if (pathStrategy == hierarchical)
+		HierarchicalMap::update (); // the map is shared by the workers, so it's brought up to date before the batch starts
+	if (PathFinder::landmarkHeuristic)
+		LandmarkMap::update ();
+	PathRequest request;
+	request.pathFinder = &pathFinder;
+	request.startPosition = position;
+	request.targetPosition = targetPosition;
+	request.pathStrategy = pathStrategy;
+	pathWorkerPool.add (request);
+	pathRequested = true;
 }
 
-// 
-void Zombie::update () {
+// takes the path found for the last requestPath, must only be called once the batch it was in is done
+void Zombie::receivePath () {
+	if (!pathRequested)
+		return;
+	pathRequested = false;
 	if (dead)
 		return;
-	moveTimer++;
-	if (moveTimer > moveInterval) {
-		move ();
-		moveTimer = 0;
+	setPath (pathFinder.path);
+}
+
+// takes a path found for the zombie somewhere else, by the PathScheduler, it must start from the zombie's position
+void Zombie::receivePath (std::vector<int> & path) {
+	pathStrategy = aStar;
+	pathFinder.clearWaypoints ();
+	setPath (path);
+}
+
+// gives back the zombie's path, so it gets a new one from where it is the next time it needs one(needsPath)
+void Zombie::releasePath () {
+	pathArena.release (path);
+	path = PathArena::none;
+	pathIndex = 0;
+	pathFinder.clearWaypoints ();
+	pathOutdated = false;
+}
+
+/* if nothing is in the way between the zombie and the targetPosition, the zombie's path is set to walk straight there and true is returned,
+so there is no need to search for it*/
+bool Zombie::followLineOfSight (Vector2 targetPosition) {
+	if (!PathFinder::hasLineOfSight (position, targetPosition)) {
+		searchesDone++;
+		return false;
+	}
+	searchesSkipped++;
+	pathFinder.clearWaypoints ();
+	pathFinder.path.assign (1, Grid::getCellIndex (targetPosition));
+	setPath (pathFinder.path);
+	return true;
+}
+
+// pulls the string of a path of cells found from the zombie's position, and keeps the waypoints left in the pathArena
+void Zombie::setPath (std::vector<int> & cells) {
+	pathCells += cells.size ();
+	PathFinder::pullString (position, cells);
+	pathWaypoints += cells.size ();
+	path = pathArena.assign (path, cells);
+	pathIndex = 0;
+	segmentStart = position;
+	segmentStep = 0;
+	pathGridCreation = PathFinder::grid.creation;
+	pathSeenChanges = PathFinder::grid.changedCells.size ();
+	pathOutdated = false;
+}
+
+/**
+** The repath policy, called for every zombie when the target moves. A path is only searched for again when there's none left to follow, it's blocked by a wall,
+** or the target drifted from the end of it by more than 1 / repathDistanceRatio of the distance between the zombie and the target, so far away zombies keep their paths longer.
+** Otherwise the zombie keeps it's path, and if the end of it can see the target, the target is added as a waypoint. If it can't, the zombie is sent again once it gets to the end.
+** The flow field is shared and hierarchical paths are refined as the zombie goes, so those always go through calculatePath and requestPath as before
+**/
+bool Zombie::needsPath (Vector2 targetPosition, PathStrategy pathStrategy) {
+	target = targetPosition;
+	if (!lazyRepaths || dead || pathStrategy != this->pathStrategy || pathStrategy == flowField || pathStrategy == hierarchical)
+		return true;
+	int length = pathArena.getLength (path);
+	if (pathIndex >= length)
+		return true;
+	if (isPathBlocked ()) {
+		repathsForBlocks++;
+		return true;
+	}
+	Vector2 pathEnd = Grid::getCellPosition (pathArena.getCell (path, length - 1));
+	if (pathEnd == targetPosition) {
+		repathsAvoided++;
+		return false;
+	}
+	if (Node::getDistance (pathEnd, targetPosition) * repathDistanceRatio > Node::getDistance (position, targetPosition)) {
+		repathsForDrift++;
+		return true;
+	}
+	if (verifyRepaths && PathFinder::grid.isWalkable (targetPosition.x, targetPosition.y)) { // no path reaches a target without room for a zombie, so there's nothing to check
+		pathFinder.findPath (pathEnd, targetPosition);
+		if (pathFinder.path.empty ()) {
+			repathVerifyFailures++;
+			return true;
+		}
+	}
+	if (PathFinder::hasLineOfSight (pathEnd, targetPosition)) {
+		pathFinder.path.assign (1, Grid::getCellIndex (targetPosition));
+		path = pathArena.append (path, pathFinder.path);
+		pathsExtended++;
+	}
+	repathsAvoided++;
+	return false;
+}
+
+// true if a wall was put on the lines between the waypoints the zombie still has to walk, only looked at when walls changed since the path was last checked
+bool Zombie::isPathBlocked () {
+	if (PathFinder::grid.creation == pathGridCreation && PathFinder::grid.changedCells.size () == pathSeenChanges)
+		return false;
+	Vector2 from = segmentStart;
+	for (int i = pathIndex; i < pathArena.getLength (path); i++) {
+		Vector2 waypoint = Grid::getCellPosition (pathArena.getCell (path, i));
+		if (!PathFinder::hasLineOfSight (from, waypoint))
+			return true;
+		from = waypoint;
 	}
+	pathGridCreation = PathFinder::grid.creation;
+	pathSeenChanges = PathFinder::grid.changedCells.size ();
+	return false;
+}
+
+int Zombie::searchesSkipped = 0;
+
+int Zombie::searchesDone = 0;
+
+long long Zombie::pathCells = 0;
+
+long long Zombie::pathWaypoints = 0;
+
+PathArena Zombie::pathArena;
+
+bool Zombie::lazyRepaths = true;
+
+bool Zombie::verifyRepaths = false;
+
+int Zombie::repathDistanceRatio = 4;
+
+int Zombie::repathsAvoided = 0;
+
+int Zombie::pathsExtended = 0;
+
+int Zombie::repathsForDrift = 0;
+
+int Zombie::repathsForBlocks = 0;
+
+int Zombie::repathVerifyFailures = 0;
+
+int Zombie::deaths = 0;
+
+/* the zombie with the collider id, or NULL if it was given back to the pool since the id was taken,
+the generation wraps around, so an old enough id can match whatever collider reuses the slot and the kind is checked too*/
+Zombie * Zombie::getZombie (int id) {
+	Collider * collider = Collider::getCollider (id);
+	if (collider == NULL || collider->getKind () != zombieCollider)
+		return NULL;
+	return static_cast<Zombie *> (collider);
+}
+
+// getter for dead
+bool Zombie::getDead () {
+	return dead;
+}
+
+// getter and setter for pathScheduled, which the PathScheduler uses so a zombie is never in it's queue twice
+bool Zombie::getPathScheduled () {
+	return pathScheduled;
+}
+
+void Zombie::setPathScheduled (bool pathScheduled) {
+	this->pathScheduled = pathScheduled;
+}
+
+// getter and setter for the zombie's index in ZombieManager::zombies, which the ZombieManager keeps up to date as zombies are removed
+int Zombie::getIndex () {
+	return index;
+}
+
+void Zombie::setIndex (int index) {
+	this->index = index;
+}
+
+// true once the zombie got to the end of a path that was kept when the target moved, so the ZombieManager sends it on to the target
+bool Zombie::getPathOutdated () {
+	return pathOutdated;
+}
+
+// the collision responses of the zombie(Collider::collisionHandlers), it dies to an attack, hurts the player, and a zombie put in a wall is dead without being counted as killed
+void Zombie::collidedWithAttack (Collider * zombie, Collider * attack) {
+	static_cast<Zombie *> (zombie)->die ();
+}
+
+void Zombie::collidedWithPlayer (Collider * collider, Collider * player) {
+	Zombie * zombie = static_cast<Zombie *> (collider);
+	static_cast<Player *> (player)->hurt ();
+	zombie->clear (zombie->previousPosition);
+	zombie->updateCollisionMatrix ();
+}
+
+void Zombie::collidedWithWall (Collider * collider, Collider * wall) {
+	Zombie * zombie = static_cast<Zombie *> (collider);
+	zombie->clear ();
+	zombie->dead = true;
+	deaths++;
+	zombie->spawnSuccessful = false;
 }
 
-// moves the zombies, makes the pathIndex to increase so the next position is used in the path found. The position is then set and the graphics rendered
+/* moves the zombies, it takes the next step on the line to the waypoint at pathIndex, and once it gets there pathIndex is increased so it walks to the next one.
+With a flow field it takes the next step from the flow field instead. The position is then set and the graphics rendered.
+A step onto a wall(one put there after the path was found) isn't taken, the zombie waits for the ZombieManager to send it on a new path instead*/
 void Zombie::move () {
-	pathIndex++;
-	if (pathIndex < path.size ()) {
-		Vector2 newPosition (path [pathIndex].position);
-		setPosition (newPosition);
-		if (dead)
+	Vector2 newPosition;
+	if (pathStrategy == flowField) {
+		if (!FlowField::getNextStep (position, newPosition) || !Wall::isAreaFree (newPosition, dimensions))
 			return;
-		graphics.setPosition (newPosition);
-		graphics.render (defaultPose);
+	} else {
+		while (pathIndex >= pathArena.getLength (path)) { // a hierarchical path is refined one segment at a time, as the zombie reaches the end of it
+			pathFinder.path.clear ();
+			if (!pathFinder.refineNextSegment (pathFinder.path))
+				break;
+			int length = pathArena.getLength (path);
+			PathFinder::pullString (length == 0 ? segmentStart : Grid::getCellPosition (pathArena.getCell (path, length - 1)), pathFinder.path);
+			path = pathArena.append (path, pathFinder.path);
+		}
+		if (pathIndex >= pathArena.getLength (path)) {
+			if (pathIndex > 0 && Grid::getCellPosition (pathArena.getCell (path, pathIndex - 1)) != target)
+				pathOutdated = true;
+			return;
+		}
+		Vector2 waypoint = Grid::getCellPosition (pathArena.getCell (path, pathIndex));
+		newPosition = PathFinder::getLinePoint (segmentStart, waypoint, segmentStep + 1);
+		if (!Wall::isAreaFree (newPosition, dimensions)) {
+			releasePath ();
+			pathOutdated = true;
+			return;
+		}
+		segmentStep++;
+		if (newPosition == waypoint) {
+			segmentStart = waypoint;
+			segmentStep = 0;
+			pathIndex++;
+		}
+	}
+	moveTo (newPosition);
+}
+
+/* moves a zombie of the mid tier(ZombieManager::setDetailTiers), it takes up to steps steps along the shared coarse flow field(HierarchicalMap::getFieldWaypoint)
+at once, without a path. It's only collided with the other colliders where it ends up. Returns false if it couldn't take a single step, so the caller can move it some other way*/
+bool Zombie::followCoarseField (int steps) {
+	Vector2 newPosition = position;
+	Vector2 waypoint;
+	for (int step = 0; step < steps; step++)
+		if (!HierarchicalMap::getFieldWaypoint (newPosition, waypoint) || !getSteeringStep (newPosition, waypoint, newPosition))
+			break;
+	if (newPosition == position)
+		return false;
+	moveTo (newPosition);
+	return true;
+}
+
+// moves a zombie of the far tier, it takes up to steps steps straight at the targetPosition at once, without a path. Like followCoarseField it's only collided with the other colliders where it ends up
+void Zombie::steer (Vector2 targetPosition, int steps) {
+	Vector2 newPosition = position;
+	for (int step = 0; step < steps && newPosition != targetPosition; step++)
+		if (!getSteeringStep (newPosition, targetPosition, newPosition))
+			break;
+	if (newPosition != position)
+		moveTo (newPosition);
+}
+
+// the step from currentPosition straight at targetPosition, or to either side of that when it's blocked by a wall, returns false if all three are blocked
+bool Zombie::getSteeringStep (Vector2 currentPosition, Vector2 targetPosition, Vector2 & step) {
+	int directionX = (targetPosition.x > currentPosition.x) - (targetPosition.x < currentPosition.x);
+	int directionY = (targetPosition.y > currentPosition.y) - (targetPosition.y < currentPosition.y);
+	Vector2 directions [3] = { Vector2 (directionX, directionY), Vector2 (directionX, 0), Vector2 (0, directionY) }; // a diagonal step, or the two straight ones in it
+	if (directionX == 0) {
+		directions [1] = Vector2 (1, directionY);
+		directions [2] = Vector2 (-1, directionY);
+	} else if (directionY == 0) {
+		directions [1] = Vector2 (directionX, 1);
+		directions [2] = Vector2 (directionX, -1);
+	}
+	for (int i = 0; i < 3; i++) {
+		Vector2 nextStep (currentPosition.x + directions [i].x, currentPosition.y + directions [i].y);
+		if (Wall::isAreaFree (nextStep, dimensions)) {
+			step = nextStep;
+			return true;
+		}
+	}
+	return false;
+}
+
+// sets the position, then renders the zombie there unless it died to what it ran into
+void Zombie::moveTo (Vector2 newPosition) {
+	setPosition (newPosition);
+	if (dead)
+		return;
+	graphics.setPosition (newPosition);
+	graphics.render (defaultPose);
+}
+
+PathScheduler::PathScheduler () {
+	current.zombie = 0;
+}
+
+// sets the target of the searches started from now on, if the current search was for an older target it's zombie will be searched again
+void PathScheduler::setTarget (Vector2 target) {
+	if (current.zombie && target != this->target)
+		currentOutdated = true;
+	this->target = target;
+}
+
+// schedules a search from the zombie to the target, unless it's already waiting for one
+void PathScheduler::add (Zombie * zombie) {
+	if (zombie->getDead ())
+		return;
+	if (zombie->getId () == current.zombie) {
+		currentOutdated = true;
+		return;
+	}
+	if (zombie->getPathScheduled () || zombie->followLineOfSight (target))
+		return;
+	zombie->setPathScheduled (true);
+	ScheduledPath scheduledPath;
+	scheduledPath.zombie = zombie->getId ();
+	scheduledPath.distance = Node::getDistance (zombie->getPosition (), target);
+	scheduledPath.scheduledTick = tick;
+	queue.push (scheduledPath);
+}
+
+// drops the zombie's search, if it's waiting in the queue it's skipped once it's reached, and if it's being searched the next one is started instead
+void PathScheduler::remove (Zombie * zombie) {
+	zombie->setPathScheduled (false);
+	if (zombie->getId () == current.zombie)
+		current.zombie = 0;
+}
+
+/**
+** Called once every update, evaluates at most expansionBudget Nodes, across as many searches as it takes
+** A search that is still going when the grid changes is started again, as the Nodes it already evaluated could be out of date
+**/
+void PathScheduler::update (int expansionBudget) {
+	tick++;
+	if (PathFinder::landmarkHeuristic)
+		LandmarkMap::update ();
+	if (current.zombie && (PathFinder::grid.creation != gridCreation || PathFinder::grid.changedCells.size () != seenChanges))
+		PathFinder::startSearch (state.startPosition, state.targetPosition, state.lowerCorner, state.upperCorner, state);
+	gridCreation = PathFinder::grid.creation;
+	seenChanges = PathFinder::grid.changedCells.size ();
+	while (expansionBudget > 0) {
+		if (!current.zombie) {
+			startNext ();
+			if (!current.zombie)
+				return;
+		}
+		expansionBudget -= PathFinder::continueSearch (state, expansionBudget, path);
+		if (!state.searching)
+			finishCurrent ();
+	}
+}
+
+// takes the closest zombie that is still alive off the queue, and starts it's search
+void PathScheduler::startNext () {
+	while (!queue.empty ()) {
+		ScheduledPath next = queue.top ();
+		queue.pop ();
+		Zombie * zombie = Zombie::getZombie (next.zombie);
+		if (!zombie)
+			continue;
+		if (zombie->getDead () || !zombie->getPathScheduled ()) { // or removed since it was scheduled
+			zombie->setPathScheduled (false);
+			continue;
+		}
+		current = next;
+		currentOutdated = false;
+		path.clear ();
+		PathFinder::startSearch (zombie->getPosition (), target, Vector2 (0, 0), Vector2 (screenWidth, screenHeight), state);
+		return;
+	}
+}
+
+// hands the path found to the zombie and counts how many ticks it waited for it, or schedules it again if the path is out of date
+void PathScheduler::finishCurrent () {
+	Zombie * zombie = Zombie::getZombie (current.zombie);
+	current.zombie = 0;
+	if (!zombie)
+		return;
+	zombie->setPathScheduled (false);
+	if (zombie->getDead ())
+		return;
+	if (zombie->getPosition () != state.startPosition) // the zombie took a step on it's old path while the search was going, so the path doesn't start where it is
+		currentOutdated = true;
+	else {
+		zombie->receivePath (path);
+		int latency = tick - current.scheduledTick;
+		completedPaths++;
+		totalLatency += latency;
+		if (latency > maxLatency)
+			maxLatency = latency;
 	}
+	if (currentOutdated)
+		add (zombie);
+}
+
+// the number of searches waiting to be done, counting the one being worked on
+int PathScheduler::getQueueDepth () {
+	return queue.size () + (current.zombie ? 1 : 0);
+}
+
+// the average number of ticks between a zombie being scheduled and receiving it's path
+float PathScheduler::getAverageLatency () {
+	return completedPaths == 0 ? 0 : (float) totalLatency / completedPaths;
+}
+
+int PathScheduler::getMaxLatency () {
+	return maxLatency;
 }
 
-// constructor
-ZombieManager::ZombieManager () {};
+const int ZombieManager::tierSteps [detailTierCount] = { 1, 2, 4 };
+
+// constructor, starts a path worker for every core
+ZombieManager::ZombieManager () : pathWorkerPool (std::thread::hardware_concurrency ()) {};
+
+// destructor, waits for the paths being searched, then gives the zombies back to the zombiePool
+ZombieManager::~ZombieManager () {
+	receivePaths ();
+	for (int i = 0; i < zombies.size (); i++)
+		zombiePool.release (zombies [i]);
+}
 
 // getter for waves
 int ZombieManager::getWaves () {
 	return waves;
 }
 
-//getter for zombies vector size
+// setter for the path strategy, zombies switch to it the next time their paths are calculated
+void ZombieManager::setPathStrategy (PathStrategy pathStrategy) {
+	this->pathStrategy = pathStrategy;
+}
+
+/* switches between searching every path in one update on the pathWorkerPool, and spreading the searches over many updates with the pathScheduler,
+at most expansionBudget Nodes are evaluated each update. Only A* searches are spread out, the other strategies always use the pathWorkerPool*/
+void ZombieManager::setTimeSlicedPaths (bool timeSlicedPaths, int expansionBudget) {
+	this->timeSlicedPaths = timeSlicedPaths;
+	this->expansionBudget = expansionBudget;
+}
+
+// sets how many zombies are spawned at once, and how close to the player they can spawn
+void ZombieManager::setSpawning (int spawnBatchSize, int minimumSpawnDistance) {
+	this->spawnBatchSize = spawnBatchSize;
+	this->minimumSpawnDistance = minimumSpawnDistance;
+}
+
+/* sets the distances(Node::getDistance) from the player past which zombies follow the shared coarse flow field, and past which they just steer at the player.
+The defaults are further than the width of the screen, so every zombie is in the near tier unless the screen is made larger*/
+void ZombieManager::setDetailTiers (int midTierDistance, int farTierDistance) {
+	this->midTierDistance = midTierDistance;
+	this->farTierDistance = farTierDistance;
+}
+
+/* sets the range the zombies spawned from now on pick their move interval from, a zombie moves once every moveInterval + 1 updates, so the lower it is the faster the zombie.
+Both default to 10, and while they are the same no random number is drawn for it, so the zombies spawn where and move as they did before*/
+void ZombieManager::setMoveIntervals (int minimumMoveInterval, int maximumMoveInterval) {
+	this->minimumMoveInterval = minimumMoveInterval;
+	this->maximumMoveInterval = maximumMoveInterval;
+}
+
+// the tier of a zombie distance away from the player
+DetailTier ZombieManager::getDetailTier (int distance) {
+	if (distance < midTierDistance)
+		return nearTier;
+	if (distance < farTierDistance)
+		return midTier;
+	return farTier;
+}
+
+/* keeps the coarse flow field the mid tier follows leading close enough to the player, it's only moved once the player is further than 1 / Zombie::repathDistanceRatio
+of midTierDistance from where it leads, the drift the lazy repaths allow for a zombie that far away. It's only calculated up to twice farTierDistance from the target,
+a zombie of the mid tier further than that along the way(around walls) steers at the player instead*/
+void ZombieManager::updateMidTierField () {
+	if (Node::getDistance (midTierTarget, playerFootprint) * Zombie::repathDistanceRatio > midTierDistance)
+		midTierTarget = playerFootprint;
+	HierarchicalMap::updateField (midTierTarget, 2 * farTierDistance); // does nothing unless the target or the walls changed
+}
+
+bool ZombieManager::getTimeSlicedPaths () {
+	return timeSlicedPaths;
+}
+
+// the number of paths the pathScheduler still has to find
+int ZombieManager::getQueuedPaths () {
+	return pathScheduler.getQueueDepth ();
+}
+
+// the average number of updates a zombie waits for it's path from the pathScheduler
+float ZombieManager::getPathLatency () {
+	return pathScheduler.getAverageLatency ();
+}
+
+//getter for the number of zombies alive
 int ZombieManager::getZombieAmount () {
 	return zombies.size ();
 }
 
-// calculates the zombies path for all zombies
+/* calculates the zombies path for all zombies that need a new one(Zombie::needsPath), with a flow field only the first zombie calculates the field and the rest reuse it.
+The searches are started on the pathWorkerPool and not waited for, the zombies receive their paths at the start of the next update.
+Only the zombies in the near tier have paths, the others are skipped*/
 void ZombieManager::calculateZombiesPaths (Vector2 position) {
+	receivePaths ();
+	position = PathFinder::grid.getFootprintPosition (position);
+	target = position;
+	bool scheduled = timeSlicedPaths && pathStrategy == aStar;
+	if (scheduled)
+		pathScheduler.setTarget (position);
+	for (int i = 0; i < zombies.size (); i++) {
+		if (zombieTiers [i] != nearTier || !zombies [i]->needsPath (position, pathStrategy))
+			continue;
+		if (scheduled)
+			pathScheduler.add (zombies [i]);
+		else
+			zombies [i]->requestPath (position, pathStrategy, pathWorkerPool);
+	}
+	if (scheduled)
+		return;
+	pathWorkerPool.start ();
+	pathsRequested = true;
+}
+
+// waits for the searches started by calculateZombiesPaths, and hands the paths found to the zombies
+void ZombieManager::receivePaths () {
+	if (!pathsRequested)
+		return;
+	pathWorkerPool.wait ();
 	for (int i = 0; i < zombies.size (); i++)
-		zombies [i]->calculatePath (position);
+		zombies [i]->receivePath ();
+	pathsRequested = false;
 }
 
-// function that updates all the zombies in the zombies vector
+/**
+** Moves the zombies whose move is due in this update, the ones in the moveWheel's slot for it, and schedules their next move. The zombies that aren't due aren't visited at all.
+** Each one's tier is found from how far it was from the player, it only drops to a lower tier once it's a quarter further than the threshold, so a zombie on the edge doesn't keep switching.
+** A zombie changing tiers drops it's path, and it's search if it leaves the near tier.
+** Then the zombies that got to the end of a path kept when the target moved, or came into the near tier, are sent on with the pathStrategy
+**/
 void ZombieManager::updateZombies () {
-	for (int i = 0; i < zombies.size (); i++)
-		zombies [i]->update ();
+	tick++;
+	dueMoves.clear ();
+	dueMoves.swap (moveWheel [tick % moveWheelSize]); // moves scheduled while going through them go in the emptied slot, not in dueMoves
+	bool pathsOutdated = false;
+	bool midTierFieldUpdated = false;
+	for (int i = 0; i < dueMoves.size (); i++) {
+		if (dueMoves [i].laps > 0) {
+			dueMoves [i].laps--;
+			moveWheel [tick % moveWheelSize].push_back (dueMoves [i]);
+			continue;
+		}
+		Zombie * zombie = Zombie::getZombie (dueMoves [i].zombie);
+		if (!zombie || zombie->getDead ()) // a zombie killed since the last update isn't moved, and isn't scheduled again
+			continue;
+		int index = zombie->getIndex ();
+		int distance = Node::getDistance (zombiePositions [index], playerFootprint);
+		DetailTier tier = getDetailTier (distance);
+		if (tier > zombieTiers [index])
+			tier = (DetailTier) std::max ((int) zombieTiers [index], (int) getDetailTier (distance * 4 / 5));
+		if (tier != zombieTiers [index]) {
+			if (tier == nearTier)
+				pathsOutdated = true;
+			else if (zombieTiers [index] == nearTier)
+				pathScheduler.remove (zombie);
+			zombie->releasePath (); // it would lead from where the zombie was when it got it, not from where it is now
+			zombieTiers [index] = tier;
+		}
+		if (tier == nearTier)
+			zombie->move ();
+		else if (tier == midTier) {
+			if (!midTierFieldUpdated)
+				updateMidTierField ();
+			midTierFieldUpdated = true;
+			if (!zombie->followCoarseField (tierSteps [tier]))
+				zombie->steer (playerFootprint, tierSteps [tier]);
+		} else
+			zombie->steer (playerFootprint, tierSteps [tier]);
+		zombiePositions [index] = zombie->getPosition ();
+		if (!zombie->getDead ())
+			scheduleMove (zombie, tierSteps [tier] * (moveIntervals [index] + 1));
+		if (tier == nearTier && zombie->getPathOutdated ())
+			pathsOutdated = true;
+	}
+	if (pathsOutdated)
+		calculateZombiesPaths (playerFootprint);
+}
+
+// puts the zombie's next move in the moveWheel, delay updates from now
+void ZombieManager::scheduleMove (Zombie * zombie, int delay) {
+	ScheduledMove scheduledMove;
+	scheduledMove.zombie = zombie->getId ();
+	scheduledMove.laps = (delay - 1) / moveWheelSize;
+	moveWheel [(tick + delay) % moveWheelSize].push_back (scheduledMove);
+}
+
+/* adds a zombie that was just spawned to the end of the zombies vector, and of the arrays of it's state, and schedules it's first move.
+The first move is offset by the number of zombies spawned before it, so zombies spawned together don't all move in the same updates*/
+void ZombieManager::addZombie (Zombie * zombie, DetailTier tier, int moveInterval) {
+	zombie->setIndex (zombies.size ());
+	zombies.push_back (zombie);
+	moveIntervals.push_back (moveInterval);
+	zombiePositions.push_back (zombie->getPosition ());
+	zombieTiers.push_back (tier);
+	if (!zombie->getDead ())
+		scheduleMove (zombie, 1 + spawnedZombies % (moveInterval + 1));
+}
+
+/* gives the dead zombies back to the zombiePool, so their slots(and their colliders' slots) are reused, and the zombies vector only has the ones alive.
+A dead zombie is swapped with the last one and popped off(in every array of the zombies' state), so the order of the zombies changes. It's called once the paths requested were received,
+so no path worker is using them, and the pathScheduler only keeps their ids, which it skips once they are gone. The zombies are only looked through after some died*/
+void ZombieManager::removeDeadZombies () {
+	if (Zombie::deaths == seenDeaths)
+		return;
+	seenDeaths = Zombie::deaths;
+	for (int i = 0; i < zombies.size (); i++) {
+		if (!zombies [i]->getDead ())
+			continue;
+		Zombie * dead = zombies [i];
+		if (i != zombies.size () - 1) { // the last zombie has nothing to swap with, and is only popped off
+			zombies [i] = zombies.back ();
+			zombies [i]->setIndex (i);
+			moveIntervals [i] = moveIntervals.back ();
+			zombiePositions [i] = zombiePositions.back ();
+			zombieTiers [i] = zombieTiers.back ();
+		}
+		zombies.pop_back ();
+		moveIntervals.pop_back ();
+		zombiePositions.pop_back ();
+		zombieTiers.pop_back ();
+		zombiePool.release (dead); // only once nothing points at it any more
+		i--; // the zombie swapped in is checked next
+	}
 }
 
-// called every update, it checks if zombietimer has exceeded the spawn interval, is so then spawn a zombie. it also increases the zombieSpawnTimer
+// called every update, it first hands out the paths requested since the last update and gives the pathScheduler it's budget, removes the dead zombies, then checks if zombietimer has exceeded the spawn interval, is so then spawn a zombie. it also increases the zombieSpawnTimer
 void ZombieManager::update (Vector2 playerPosition) {
+	playerFootprint = PathFinder::grid.getFootprintPosition (playerPosition);
+	receivePaths ();
+	if (timeSlicedPaths)
+		pathScheduler.update (expansionBudget);
+	removeDeadZombies ();
 	zombieSpawnTimer++;
 	if (zombieSpawnTimer > zombieSpawnInterval) {
-		spawnZombie (playerPosition);
+		spawnZombies (playerPosition, spawnBatchSize);
 		zombieSpawnTimer = 0;
 	}
 	updateZombies ();
 }
 
-/*used to spawn a zombie, if the spawn was successful,
-meaning it doesnt collide spawn within non walkable areas
-or on the player then the zombie is created and added to the vector of zombies,
-the zombie amount is also checked to increase the wave and decrease spawn interval if neccesssary */
-void ZombieManager::spawnZombie (Vector2 playerPosition) {
-	bool spawnSuccessful = false;
-	do {
-		Vector2 spawnPosition (rand () % screenWidth, rand () % screenHeight);
-		if (Wall::walkableAreas [spawnPosition.x] [spawnPosition.y] && spawnPosition != playerPosition) {
-			spawnSuccessful = true;
-			zombies.push_back (new Zombie (spawnPosition, playerPosition));
-			if (getZombieAmount () > 10 * waves) {
-				waves++;
-				zombieSpawnInterval *= 0.8;
-			}
+/*used to spawn a zombie, the spawn position is picked at random from the walkable Nodes of the grid(Grid::walkableCells), where the whole zombie is off the walls,
+if it's far enough from the player and no other collider is there the zombie is created and added to the vector of zombies(and searched a path for if it's in the near tier), otherwise another one is tried, up to spawnAttempts times.
+the zombie amount is also checked to increase the wave and decrease spawn interval if neccesssary. Returns false if no place was found */
+bool ZombieManager::spawnZombie (Vector2 playerPosition) {
+	std::vector<int> & spawnCells = PathFinder::grid.walkableCells;
+	for (int attempt = 0; attempt < spawnAttempts && !spawnCells.empty (); attempt++) {
+		Vector2 spawnPosition = Grid::getCellPosition (spawnCells [rand () % spawnCells.size ()]);
+		if (Node::getDistance (spawnPosition, playerPosition) < minimumSpawnDistance || !Collider::isAreaEmpty (spawnPosition, Vector2 (Grid::footprintSize, Grid::footprintSize)))
+			continue;
+		Zombie * zombie = zombiePool.acquire (spawnPosition);
+		DetailTier tier = getDetailTier (Node::getDistance (spawnPosition, playerPosition));
+		int moveInterval = minimumMoveInterval;
+		if (maximumMoveInterval > minimumMoveInterval)
+			moveInterval += rand () % (maximumMoveInterval - minimumMoveInterval + 1);
+		addZombie (zombie, tier, moveInterval);
+		if (tier == nearTier)
+			zombie->calculatePath (PathFinder::grid.getFootprintPosition (playerPosition), pathStrategy);
+		spawnedZombies++;
+		if (spawnedZombies > 10 * waves) {
+			waves++;
+			zombieSpawnInterval *= 0.8;
 		}
-	} while (!spawnSuccessful);
+		return true;
+	}
+	return false;
+}
+
+// spawns up to count zombies, and returns how many were spawned
+int ZombieManager::spawnZombies (Vector2 playerPosition, int count) {
+	int spawned = 0;
+	for (int i = 0; i < count; i++)
+		if (spawnZombie (playerPosition))
+			spawned++;
+	return spawned;
 }
 
 /*Wall constructor, the position and dimensions of the wall is passed into the constructor,
 the for loops that initializes the static array walkable areas are only called once when the first wall object is created
 the initial collision detection is done, then the walkableAreas array updated to account for the new wall, after that the graphics are rendered*/
-Wall::Wall (Vector2 position, Vector2 dimensions) : Collider (position, dimensions), graphics (position, dimensions) {
+Wall::Wall (Vector2 position, Vector2 dimensions) : Collider (position, dimensions, wallCollider), graphics (position, dimensions) {
 	if (!initialized) {
 		initialized = true;
 		for (int x = 0; x < screenWidth; x++)
@@ -639,23 +3537,36 @@ Wall::Wall (Vector2 position, Vector2 dimensions) : Collider (position, dimensio
 	graphics.render (219);
 }
 
-/* function override of Collider base class's pure virtual collided function,
-called when the Wall collides with another collider, the collider that it collides with is passed into the function
-if the collider is another wall, the wall will overlap the collided wall by updating the collision matrix */
-void Wall::collided (Collider * collider) {
-	if (dynamic_cast<Wall *> (collider))
-		updateCollisionMatrix ();
+/* collision handler for a Wall put on another wall(Collider::collisionHandlers),
+the wall will overlap the collided wall by updating the collision matrix */
+void Wall::collidedWithWall (Collider * wall, Collider * otherWall) {
+	static_cast<Wall *> (wall)->updateCollisionMatrix ();
 }
 
 /*a 2d bool array that stores data to all the transversible and non transversible positions,
 it is used by the pathfinding system*/
 bool Wall::walkableAreas [screenWidth] [screenHeight];
 
-/*updates the walkable areas bool array*/
+/*updates the walkable areas bool array, and the clearance of the pathfinding grid around the wall*/
 void Wall::updateWalkableAreas () {
 	for (int x = position.x; x < position.x + dimensions.x; x++)
 		for (int y = position.y; y < position.y + dimensions.y; y++)
 			walkableAreas [x] [y] = false;
+	for (int x = position.x + 1; x <= screenWidth; x++) // only the corners below and to the right of the wall count any of it's cells
+		for (int y = position.y + 1; y <= screenHeight; y++)
+			wallCellsBefore [x] [y] = !walkableAreas [x - 1] [y - 1] + wallCellsBefore [x - 1] [y] + wallCellsBefore [x] [y - 1] - wallCellsBefore [x - 1] [y - 1];
+	PathFinder::grid.updateClearance (position, Vector2 (position.x + dimensions.x, position.y + dimensions.y));
+	FlowField::invalidate ();
+}
+
+int Wall::wallCellsBefore [screenWidth + 1] [screenHeight + 1];
+
+// true if the rectangle at position, of the given dimensions, is inside the screen and has no wall cell in it, in constant time from the corners of the summed-area table
+bool Wall::isAreaFree (Vector2 position, Vector2 dimensions) {
+	int right = position.x + dimensions.x, bottom = position.y + dimensions.y;
+	if (position.x < 0 || position.y < 0 || right > screenWidth || bottom > screenHeight)
+		return false;
+	return wallCellsBefore [right] [bottom] - wallCellsBefore [position.x] [bottom] - wallCellsBefore [right] [position.y] + wallCellsBefore [position.x] [position.y] == 0;
 }
 
 /* static flag for checking if a wall object has been created,
@@ -664,20 +3575,20 @@ bool Wall::initialized = false;
 
 /* attack constructor, position and dimensions passed in, base class constructor called,
 then the initial collision detection done by calling setPosition method*/
-Attack::Attack (Vector2 position, Vector2 dimensions) : Collider (position, dimensions) {
+Attack::Attack (Vector2 position, Vector2 dimensions) : Collider (position, dimensions, attackCollider) {
 	setPosition (position);
 }
 
-/* function override of Collider base class's pure virtual collided function,
-called when the attack collides with another collider, if the collider is a zombie, then the zombie dies,
+/* collision handlers of the attack(Collider::collisionHandlers), if the collider is a zombie, then the zombie dies,
 and the collisions updated, if it collides with a wall, blocked is set to true, blocked is a flag for if the
 attack is allowed, so if it collides with a wall the attack is not allowed */
-void Attack::collided (Collider * collider) {
-	if (Zombie * zombie = dynamic_cast<Zombie *> (collider)) {
-		zombie->die ();
-		updateCollisionMatrix ();
-	} else if (dynamic_cast<Wall *> (collider))
-		blocked = true;
+void Attack::collidedWithZombie (Collider * attack, Collider * zombie) {
+	static_cast<Zombie *> (zombie)->die ();
+	static_cast<Attack *> (attack)->updateCollisionMatrix ();
+}
+
+void Attack::collidedWithWall (Collider * attack, Collider * wall) {
+	static_cast<Attack *> (attack)->blocked = true;
 }
 
 // getter for blocked variable
@@ -688,7 +3599,7 @@ bool Attack::getBlocked () {
 /* constructor for player, the position is passed into the constructor and used to set the initial position
 of the graphics and collider hitbox, the dimensions of the player (3 by 3) is also passed into the constructors of graphics and collider
 finally, the setPosition method is called to do the first collision check when it is created.*/
-Player::Player (Vector2 position) : Collider (Vector2 (position), Vector2 (3, 3)), graphics (position, Vector2 (3, 3)) {
+Player::Player (Vector2 position) : Collider (Vector2 (position), Vector2 (3, 3), playerCollider), graphics (position, Vector2 (3, 3)) {
 	setPosition (position);
 }
 
@@ -709,17 +3620,19 @@ void Player::hurt () {
 		die ();
 }
 
-/* function override of Collider base class's pure virtual collided fucntion,
-called when the player collides with another collider, the collider that it collides with is passed into the function
+/* collision handlers of the player(Collider::collisionHandlers),
 if the collider is a zombie, the player gets hurt and updates its colliders, else if the collider is a wall then set
 position to the previous position, so the player wont go inside the wall. */
-void Player::collided (Collider * collider) {
-	if (dynamic_cast<Zombie *> (collider)) {
-		hurt ();
-		clear (previousPosition);
-		updateCollisionMatrix ();
-	} else if (dynamic_cast<Wall *> (collider))
-		setPosition (previousPosition);
+void Player::collidedWithZombie (Collider * collider, Collider * zombie) {
+	Player * player = static_cast<Player *> (collider);
+	player->hurt ();
+	player->clear (player->previousPosition);
+	player->updateCollisionMatrix ();
+}
+
+void Player::collidedWithWall (Collider * collider, Collider * wall) {
+	Player * player = static_cast<Player *> (collider);
+	player->setPosition (player->previousPosition);
 }
 
 /* moves the player according to the input passed, and then stores the previousInput to be used by the attack system
@@ -727,24 +3640,27 @@ after the movement the graphics of the player is updated. No movement will occur
 void Player::move (char input) {
 	if (dead || attackTimer < 5)
 		return;
+	Vector2 newPosition = position;
 	switch (input) {
 		case 'w':
-			setPosition (Vector2 (position.x, position.y - 1));
+			newPosition = Vector2 (position.x, position.y - 1);
 			previousMovementInput = input;
 			break;
 		case 'a':
-			setPosition (Vector2 (position.x - 2, position.y));
+			newPosition = Vector2 (position.x - 2, position.y);
 			previousMovementInput = input;
 			break;
 		case 's':
-			setPosition (Vector2 (position.x, position.y + 1));
+			newPosition = Vector2 (position.x, position.y + 1);
 			previousMovementInput = input;
 			break;
 		case 'd':
-			setPosition (Vector2 (position.x + 2, position.y));
+			newPosition = Vector2 (position.x + 2, position.y);
 			previousMovementInput = input;
 			break;
 	}
+	if (newPosition != position && Wall::isAreaFree (newPosition, dimensions)) // a move into a wall is ignored, instead of taken and undone in collided
+		setPosition (newPosition);
 	graphics.setPosition (position);
 	graphics.render (defaultPose);
 }
@@ -764,15 +3680,17 @@ void Player::update () {
 		endAttack ();
 }
 
-// called when player attack, this initiates an attack, the graphics has to be extruded for the attack
+// called when player attack, this initiates an attack, the graphics has to be extruded for the attack. An attack that is still going is ended first
 void Player::beginAttack () {
 	if (dead || attackTimer < 5)
 		return;
+	if (attack)
+		endAttack ();
 	attackTimer = 0;
 	switch (previousMovementInput) {
 		case 'w':
 			attackDirection = up;
-			attack = new Attack (Vector2 (position.x, position.y - 2), Vector2 (3, 2));
+			attack = attackPool.acquire (Vector2 (position.x, position.y - 2), Vector2 (3, 2));
 			if (!attack->getBlocked ()) {
 				graphics.extrude (attackDirection, 1);
 				graphics.render (attackUpPose);
@@ -780,7 +3698,7 @@ void Player::beginAttack () {
 			break;
 		case 'a':
 			attackDirection = left;
-			attack = new Attack (Vector2 (position.x - 2, position.y), Vector2 (2, 3));
+			attack = attackPool.acquire (Vector2 (position.x - 2, position.y), Vector2 (2, 3));
 			if (!attack->getBlocked ()) {
 				graphics.extrude (attackDirection, 1);
 				graphics.render (attackLeftPose);
@@ -788,7 +3706,7 @@ void Player::beginAttack () {
 			break;
 		case 's':
 			attackDirection = down;
-			attack = new Attack (Vector2 (position.x, position.y + 3), Vector2 (3, 2));
+			attack = attackPool.acquire (Vector2 (position.x, position.y + 3), Vector2 (3, 2));
 			if (!attack->getBlocked ()) {
 				graphics.extrude (attackDirection, 1);
 				graphics.render (attackDownPose);
@@ -796,7 +3714,7 @@ void Player::beginAttack () {
 			break;
 		case 'd':
 			attackDirection = right;
-			attack = new Attack (Vector2 (position.x + 3, position.y), Vector2 (2, 3));
+			attack = attackPool.acquire (Vector2 (position.x + 3, position.y), Vector2 (2, 3));
 			if (!attack->getBlocked ()) {
 				graphics.extrude (attackDirection, 1);
 				graphics.render (attackRightPose);
@@ -813,7 +3731,8 @@ void Player::endAttack () {
 			graphics.extrude (attackDirection, -1);
 		}
 		attack->clear ();
-		delete attack;
+		attackPool.release (attack);
+		attack = NULL;
 	}
 	graphics.render (defaultPose);
 }
@@ -896,8 +3815,10 @@ void Game::update () {
 		if (input == ' ')
 			player.beginAttack ();
 		else {
+			Vector2 previousPosition = player.getPosition ();
 			player.move (input);
-			zombieManager.calculateZombiesPaths (player.getPosition ());
+			if (player.getPosition () != previousPosition) // other keys, and moves into walls, leave the zombies' paths as they are
+				zombieManager.calculateZombiesPaths (player.getPosition ());
 		}
 		if (gameOver && input == 'r') {
 			running = false;
@@ -930,6 +3851,35 @@ void Game::draw () {
 		<< "\tZombies : " << zombieManager.getZombieAmount ()
 		<< "\tWave : " << zombieManager.getWaves ()
 		<< "\t[W, A, S, D] to move, [Spacebar] to attack." << std::endl;
+	if (zombieManager.getTimeSlicedPaths ())
+		std::cout << "Queued paths : " << zombieManager.getQueuedPaths ()
+			<< "\tPath latency : " << zombieManager.getPathLatency () << " ticks" << std::endl;
+	int lineOfSightChecks = Zombie::searchesSkipped + Zombie::searchesDone;
+	if (lineOfSightChecks > 0)
+		std::cout << "Searches skipped : " << 100LL * Zombie::searchesSkipped / lineOfSightChecks << "%"
+			<< "\tWaypoints stored : " << (Zombie::pathCells == 0 ? 0 : 100 * Zombie::pathWaypoints / Zombie::pathCells) << "% of path cells" << std::endl;
+	int incrementalSearches = IncrementalPlanner::replans + IncrementalPlanner::restarts;
+	if (incrementalSearches > 0)
+		std::cout << "Replans : " << IncrementalPlanner::replans
+			<< "\tRestarts : " << IncrementalPlanner::restarts
+			<< "\tNodes per search : " << IncrementalPlanner::totalExpansions / incrementalSearches << std::endl;
+	if (PathFinder::landmarkHeuristic && LandmarkMap::ready) {
+		std::cout << "Landmarks : ";
+		if (LandmarkMap::calculateMilliseconds == 0)
+			std::cout << "loaded from file";
+		else
+			std::cout << "calculated in " << LandmarkMap::calculateMilliseconds << " ms";
+		std::cout << "\tTables : " << LandmarkMap::getMemoryUsage () / 1024 << " KB" << std::endl;
+	}
+	if (Zombie::repathsAvoided + Zombie::repathsForDrift + Zombie::repathsForBlocks > 0) {
+		std::cout << "Repaths avoided : " << Zombie::repathsAvoided
+			<< "\tPaths extended : " << Zombie::pathsExtended
+			<< "\tRepaths for drift : " << Zombie::repathsForDrift
+			<< "\tFor blocked paths : " << Zombie::repathsForBlocks;
+		if (Zombie::verifyRepaths)
+			std::cout << "\tFailed checks : " << Zombie::repathVerifyFailures;
+		std::cout << std::endl;
+	}
 	if (gameOver)
 		std::cout << "tHe zOmBiEs AtE uR bRaiNs, press 'r' to terminate game" << std::endl;
 }